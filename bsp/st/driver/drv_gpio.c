@@ -16,6 +16,26 @@
 #define PIN_STPORT(pin)     ((GPIO_TypeDef *)(GPIOA_BASE + (0x400u * PIN_PORT(pin))))
 #define PIN_STPIN(pin)      ((uint16_t)(1u << (mr_uint8_t)(pin & 0x0Fu)))
 
+/* The exti registers differ between series, the edges pend apart on some (RPR1/FPR1) */
+#if defined(EXTI_D1)
+#if defined(DUAL_CORE) && defined(CORE_CM4)
+#define PIN_EXTI_PENDING()    (EXTI_D2->PR1 & EXTI_D2->IMR1)
+#define PIN_EXTI_CLEAR(lines) (EXTI_D2->PR1 = (lines))
+#else
+#define PIN_EXTI_PENDING()    (EXTI_D1->PR1 & EXTI_D1->IMR1)
+#define PIN_EXTI_CLEAR(lines) (EXTI_D1->PR1 = (lines))
+#endif
+#elif defined(EXTI_RPR1_RPIF0)
+#define PIN_EXTI_PENDING()    ((EXTI->RPR1 | EXTI->FPR1) & EXTI->IMR1)
+#define PIN_EXTI_CLEAR(lines) do { EXTI->RPR1 = (lines); EXTI->FPR1 = (lines); } while (0)
+#elif defined(EXTI_PR1_PIF0)
+#define PIN_EXTI_PENDING()    (EXTI->PR1 & EXTI->IMR1)
+#define PIN_EXTI_CLEAR(lines) (EXTI->PR1 = (lines))
+#else
+#define PIN_EXTI_PENDING()    (EXTI->PR & EXTI->IMR)
+#define PIN_EXTI_CLEAR(lines) (EXTI->PR = (lines))
+#endif
+
 static IRQn_Type irq[] =
     {
         EXTI0_IRQn,
@@ -244,94 +264,76 @@ static void drv_pin_write(mr_pin_t pin, mr_off_t number, mr_level_t level)
     HAL_GPIO_WritePin(PIN_STPORT(number), PIN_STPIN(number), (GPIO_PinState)level);
 }
 
-void EXTI0_IRQHandler(void)
+static mr_uint32_t drv_pin_port_read(mr_pin_t pin, mr_off_t port)
 {
-    if (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_0) != RESET)
+    if (port >= MR_BSP_PIN_NUMBER / 16)
     {
-        mr_pin_device_isr(&pin_device, irq_mask[0]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_0);
+        return 0;
     }
+
+    return PIN_STPORT(port << 4)->IDR;
 }
 
-void EXTI1_IRQHandler(void)
+static void drv_pin_port_write_masked(mr_pin_t pin, mr_off_t port, mr_uint32_t set, mr_uint32_t clear)
 {
-    if (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_1) != RESET)
+    if (port >= MR_BSP_PIN_NUMBER / 16)
     {
-        mr_pin_device_isr(&pin_device, irq_mask[1]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_1);
+        return;
     }
+
+    /* One store sets and clears the pins, set wins */
+    PIN_STPORT(port << 4)->BSRR = (set & 0xffffu) | ((clear & 0xffffu) << 16);
 }
 
-void EXTI2_IRQHandler(void)
+static void drv_pin_isr(mr_uint32_t lines)
 {
-    if (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_2) != RESET)
+    mr_uint32_t pending = PIN_EXTI_PENDING() & lines;
+    mr_uint32_t line = 0;
+
+    /* Walk only the pending lines, lowest first (count trailing zeros) */
+    while (pending != 0)
     {
-        mr_pin_device_isr(&pin_device, irq_mask[2]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_2);
+        line = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        PIN_EXTI_CLEAR(1u << line);
+        mr_pin_device_isr(&pin_device, irq_mask[line]);
     }
 }
 
+void EXTI0_IRQHandler(void)
+{
+    drv_pin_isr(GPIO_PIN_0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+    drv_pin_isr(GPIO_PIN_1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+    drv_pin_isr(GPIO_PIN_2);
+}
+
 void EXTI3_IRQHandler(void)
 {
-    if (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_3) != RESET)
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[3]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_3);
-    }
+    drv_pin_isr(GPIO_PIN_3);
 }
 
 void EXTI4_IRQHandler(void)
 {
-    if (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_4) != RESET)
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[4]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_4);
-    }
+    drv_pin_isr(GPIO_PIN_4);
 }
 
 void EXTI9_5_IRQHandler(void)
 {
-    if ((__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_5) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_6) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_7) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_8) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_9) != RESET))
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[5]);
-        mr_pin_device_isr(&pin_device, irq_mask[6]);
-        mr_pin_device_isr(&pin_device, irq_mask[7]);
-        mr_pin_device_isr(&pin_device, irq_mask[8]);
-        mr_pin_device_isr(&pin_device, irq_mask[9]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_5);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_6);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_7);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_8);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_9);
-    }
+    drv_pin_isr(GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9);
 }
 
 void EXTI15_10_IRQHandler(void)
 {
-    if ((__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_10) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_11) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_12) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_13) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_14) != RESET)
-        || (__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_15) != RESET))
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[10]);
-        mr_pin_device_isr(&pin_device, irq_mask[11]);
-        mr_pin_device_isr(&pin_device, irq_mask[12]);
-        mr_pin_device_isr(&pin_device, irq_mask[13]);
-        mr_pin_device_isr(&pin_device, irq_mask[14]);
-        mr_pin_device_isr(&pin_device, irq_mask[15]);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_10);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_11);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_12);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_13);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_14);
-        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_15);
-    }
+    drv_pin_isr(GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12 | GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15);
 }
 
 mr_err_t drv_gpio_init(void)
@@ -341,6 +343,8 @@ mr_err_t drv_gpio_init(void)
             drv_pin_configure,
             drv_pin_read,
             drv_pin_write,
+            drv_pin_port_read,
+            drv_pin_port_write_masked,
         };
     mr_err_t ret = MR_ERR_OK;
 
@@ -12,6 +12,14 @@
 
 #if (MR_CFG_SERIAL == MR_CFG_ENABLE)
 
+#if (MR_CFG_PIN == MR_CFG_ENABLE)
+#include "device/pin.h"
+#endif
+
+#define PIN_PORT(pin)       ((uint8_t)(((pin) >> 4) & 0x0Fu))
+#define PIN_STPORT(pin)     ((GPIO_TypeDef *)(GPIOA_BASE + (0x400u * PIN_PORT(pin))))
+#define PIN_STPIN(pin)      ((uint16_t)(1u << (mr_uint8_t)(pin & 0x0Fu)))
+
 enum
 {
 #ifdef MR_BSP_UART_1
@@ -40,36 +48,92 @@ enum
 #endif
 };
 
+/* The rts and de pins are driven by software, see mrboard.h */
 static struct drv_uart_data drv_uart_data[] =
     {
 #ifdef MR_BSP_UART_1
-        {"uart1", {0}, USART1, USART1_IRQn},
+        {"uart1", {0}, USART1, USART1_IRQn, MR_BSP_UART_1_RTS_PIN, MR_BSP_UART_1_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_2
-        {"uart2", {0}, USART2, USART2_IRQn},
+        {"uart2", {0}, USART2, USART2_IRQn, MR_BSP_UART_2_RTS_PIN, MR_BSP_UART_2_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_3
-        {"uart3", {0}, USART3, USART3_IRQn},
+        {"uart3", {0}, USART3, USART3_IRQn, MR_BSP_UART_3_RTS_PIN, MR_BSP_UART_3_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_4
-        {"uart4", {0}, UART4, UART4_IRQn},
+        {"uart4", {0}, UART4, UART4_IRQn, MR_BSP_UART_4_RTS_PIN, MR_BSP_UART_4_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_5
-        {"uart5", {0}, UART5, UART5_IRQn},
+        {"uart5", {0}, UART5, UART5_IRQn, MR_BSP_UART_5_RTS_PIN, MR_BSP_UART_5_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_6
-        {"uart6", {0}, USART6, USART6_IRQn},
+        {"uart6", {0}, USART6, USART6_IRQn, MR_BSP_UART_6_RTS_PIN, MR_BSP_UART_6_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_7
-        {"uart7", {0}, UART7, UART7_IRQn},
+        {"uart7", {0}, UART7, UART7_IRQn, MR_BSP_UART_7_RTS_PIN, MR_BSP_UART_7_DE_PIN},
 #endif
 #ifdef MR_BSP_UART_8
-        {"uart8", {0}, UART8, UART8_IRQn},
+        {"uart8", {0}, UART8, UART8_IRQn, MR_BSP_UART_8_RTS_PIN, MR_BSP_UART_8_DE_PIN},
 #endif
     };
 
 static struct mr_serial serial_device[mr_array_num(drv_uart_data)];
 
+static mr_err_t drv_serial_configure_pin(mr_off_t number)
+{
+#if (MR_CFG_PIN == MR_CFG_ENABLE)
+    struct mr_pin_config pin_config;
+    mr_device_t pin = MR_NULL;
+
+    if (number < 0 || number >= MR_BSP_PIN_NUMBER)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    pin_config.number = number;
+    pin_config.mode = MR_PIN_MODE_OUTPUT;
+
+    /* Configure pin */
+    pin = mr_device_find("pin");
+    if (pin != MR_NULL)
+    {
+        return mr_device_ioctl(pin, MR_DEVICE_CTRL_SET_CONFIG, &pin_config);
+    }
+#endif
+
+    return MR_ERR_UNSUPPORTED;
+}
+
+static void drv_serial_enable_rx_timeout(mr_serial_t serial, mr_uint32_t timeout)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+#ifdef USART_CR2_RTOEN
+    /* The receiver timeout counts the bit times of quiet line after the last stop bit */
+    if (timeout != 0)
+    {
+        MODIFY_REG(uart_data->handle.Instance->RTOR, USART_RTOR_RTO, timeout);
+        WRITE_REG(uart_data->handle.Instance->ICR, USART_ICR_RTOCF);
+        SET_BIT(uart_data->handle.Instance->CR2, USART_CR2_RTOEN);
+        SET_BIT(uart_data->handle.Instance->CR1, USART_CR1_RTOIE);
+    } else
+    {
+        CLEAR_BIT(uart_data->handle.Instance->CR1, USART_CR1_RTOIE);
+        CLEAR_BIT(uart_data->handle.Instance->CR2, USART_CR2_RTOEN);
+    }
+#else
+    /* Without receiver timeout the idle line (one frame) is the timeout */
+    if (timeout != 0)
+    {
+        __HAL_UART_CLEAR_IDLEFLAG(&uart_data->handle);
+        __HAL_UART_ENABLE_IT(&uart_data->handle, UART_IT_IDLE);
+    } else
+    {
+        __HAL_UART_DISABLE_IT(&uart_data->handle, UART_IT_IDLE);
+    }
+#endif
+}
+
 static mr_err_t drv_serial_configure(mr_serial_t serial, struct mr_serial_config *config)
 {
     struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
@@ -158,8 +222,50 @@ static mr_err_t drv_serial_configure(mr_serial_t serial, struct mr_serial_config
             return MR_ERR_INVALID;
     }
 
+    switch (config->flow_control)
+    {
+        case MR_SERIAL_FLOW_CONTROL_NONE:
+        {
+            uart_data->handle.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+            break;
+        }
+
+        case MR_SERIAL_FLOW_CONTROL_RTS_CTS:
+        {
+            /* The hardware only watches the cts, the rts follows the fifo */
+            if (drv_serial_configure_pin(uart_data->rts_pin) != MR_ERR_OK)
+            {
+                return MR_ERR_UNSUPPORTED;
+            }
+            uart_data->handle.Init.HwFlowCtl = UART_HWCONTROL_CTS;
+            break;
+        }
+
+        default:
+            return MR_ERR_INVALID;
+    }
+
+    switch (config->mode)
+    {
+        case MR_SERIAL_MODE_NORMAL:
+        {
+            break;
+        }
+
+        case MR_SERIAL_MODE_RS485:
+        {
+            if (drv_serial_configure_pin(uart_data->de_pin) != MR_ERR_OK)
+            {
+                return MR_ERR_UNSUPPORTED;
+            }
+            break;
+        }
+
+        default:
+            return MR_ERR_INVALID;
+    }
+
     uart_data->handle.Init.BaudRate = config->baud_rate;
-    uart_data->handle.Init.HwFlowCtl = UART_HWCONTROL_NONE;
     uart_data->handle.Init.Mode = UART_MODE_TX_RX;
     uart_data->handle.Init.OverSampling = UART_OVERSAMPLING_16;
 
@@ -172,6 +278,10 @@ static mr_err_t drv_serial_configure(mr_serial_t serial, struct mr_serial_config
     HAL_NVIC_EnableIRQ(uart_data->irq_type);
     __HAL_UART_ENABLE_IT(&uart_data->handle, UART_IT_RXNE);
 
+    /* The receive timeout may be set before the uart is initialized */
+    drv_serial_enable_rx_timeout(serial, serial->rx_timeout);
+    __HAL_UART_DISABLE_IT(&uart_data->handle, UART_IT_TC);
+
     return MR_ERR_OK;
 }
 
@@ -180,7 +290,7 @@ static void drv_serial_write(mr_serial_t serial, mr_uint8_t data)
     struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
     mr_size_t i = 0;
 
-    while (__HAL_UART_GET_FLAG(&uart_data->handle, UART_FLAG_TC) == RESET)
+    while (__HAL_UART_GET_FLAG(&uart_data->handle, UART_FLAG_TXE) == RESET)
     {
         i++;
         if (i > MR_UINT16_MAX)
@@ -221,6 +331,52 @@ static void drv_serial_stop_tx(mr_serial_t serial)
     __HAL_UART_DISABLE_IT(&uart_data->handle, UART_IT_TXE);
 }
 
+static mr_err_t drv_serial_set_rx_timeout(mr_serial_t serial, mr_uint32_t timeout)
+{
+#ifdef USART_CR2_RTOEN
+    if (timeout > USART_RTOR_RTO)
+    {
+        return MR_ERR_INVALID;
+    }
+#else
+    /* Only the idle line can be timed, a timeout longer than one frame cannot */
+    if (timeout > MR_SERIAL_FRAME_BITS(&serial->config))
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+#endif
+
+    drv_serial_enable_rx_timeout(serial, timeout);
+    return MR_ERR_OK;
+}
+
+static void drv_serial_set_rts(mr_serial_t serial, mr_state_t state)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    /* The rts is active low */
+    HAL_GPIO_WritePin(PIN_STPORT(uart_data->rts_pin),
+                      PIN_STPIN(uart_data->rts_pin),
+                      (state == MR_ENABLE) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+static void drv_serial_set_de(mr_serial_t serial, mr_state_t state)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    /* The de is held until the transmission complete (last stop bit sent), not the empty data register */
+    if (state == MR_ENABLE)
+    {
+        HAL_GPIO_WritePin(PIN_STPORT(uart_data->de_pin), PIN_STPIN(uart_data->de_pin), GPIO_PIN_SET);
+        __HAL_UART_CLEAR_FLAG(&uart_data->handle, UART_FLAG_TC);
+        __HAL_UART_ENABLE_IT(&uart_data->handle, UART_IT_TC);
+    } else
+    {
+        __HAL_UART_DISABLE_IT(&uart_data->handle, UART_IT_TC);
+        HAL_GPIO_WritePin(PIN_STPORT(uart_data->de_pin), PIN_STPIN(uart_data->de_pin), GPIO_PIN_RESET);
+    }
+}
+
 static void drv_serial_isr(mr_serial_t serial)
 {
     struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
@@ -231,11 +387,35 @@ static void drv_serial_isr(mr_serial_t serial)
         mr_serial_device_isr(serial, MR_SERIAL_EVENT_RX_INT);
     }
 
+    /* The received data is taken first, clearing the idle flag reads the data register */
+    if (__HAL_UART_GET_FLAG(&uart_data->handle, UART_FLAG_IDLE) != RESET &&
+        __HAL_UART_GET_IT_SOURCE(&uart_data->handle, UART_IT_IDLE) != RESET)
+    {
+        __HAL_UART_CLEAR_IDLEFLAG(&uart_data->handle);
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_RX_IDLE);
+    }
+
+#ifdef USART_CR2_RTOEN
+    if (READ_BIT(uart_data->handle.Instance->ISR, USART_ISR_RTOF) != RESET &&
+        READ_BIT(uart_data->handle.Instance->CR1, USART_CR1_RTOIE) != RESET)
+    {
+        WRITE_REG(uart_data->handle.Instance->ICR, USART_ICR_RTOCF);
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_RX_IDLE);
+    }
+#endif
+
     if (__HAL_UART_GET_FLAG(&uart_data->handle, UART_FLAG_TXE) != RESET &&
         __HAL_UART_GET_IT_SOURCE(&uart_data->handle, UART_IT_TXE) != RESET)
     {
         mr_serial_device_isr(serial, MR_SERIAL_EVENT_TX_INT);
     }
+
+    if (__HAL_UART_GET_FLAG(&uart_data->handle, UART_FLAG_TC) != RESET &&
+        __HAL_UART_GET_IT_SOURCE(&uart_data->handle, UART_IT_TC) != RESET)
+    {
+        __HAL_UART_CLEAR_FLAG(&uart_data->handle, UART_FLAG_TC);
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_TX_DONE);
+    }
 }
 
 #ifdef MR_BSP_UART_1
@@ -303,6 +483,16 @@ mr_err_t drv_uart_init(void)
             drv_serial_read,
             drv_serial_start_tx,
             drv_serial_stop_tx,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            drv_serial_set_rx_timeout,
+            drv_serial_set_rts,
+            drv_serial_set_de,
         };
     mr_size_t count = mr_array_num(serial_device);
     mr_err_t ret = MR_ERR_OK;
@@ -26,6 +26,8 @@ struct drv_uart_data
     UART_HandleTypeDef handle;
     USART_TypeDef *instance;
     IRQn_Type irq_type;
+    mr_off_t rts_pin;
+    mr_off_t de_pin;
 };
 
 #endif
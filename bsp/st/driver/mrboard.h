@@ -41,6 +41,26 @@ extern "C" {
 #define MR_BSP_UART_7
 #define MR_BSP_UART_8
 
+/**
+ * @def Bsp uart rts and de pins (driven by software), -1 if not connected
+ */
+#define MR_BSP_UART_1_RTS_PIN           -1
+#define MR_BSP_UART_1_DE_PIN            -1
+#define MR_BSP_UART_2_RTS_PIN           -1
+#define MR_BSP_UART_2_DE_PIN            -1
+#define MR_BSP_UART_3_RTS_PIN           -1
+#define MR_BSP_UART_3_DE_PIN            -1
+#define MR_BSP_UART_4_RTS_PIN           -1
+#define MR_BSP_UART_4_DE_PIN            -1
+#define MR_BSP_UART_5_RTS_PIN           -1
+#define MR_BSP_UART_5_DE_PIN            -1
+#define MR_BSP_UART_6_RTS_PIN           -1
+#define MR_BSP_UART_6_DE_PIN            -1
+#define MR_BSP_UART_7_RTS_PIN           -1
+#define MR_BSP_UART_7_DE_PIN            -1
+#define MR_BSP_UART_8_RTS_PIN           -1
+#define MR_BSP_UART_8_DE_PIN            -1
+
 /**
  * @def Bsp adc
  */
@@ -12,13 +12,37 @@
 
 #if (MR_CFG_ADC == MR_CFG_ENABLE)
 
+/* The scan is triggered by the trigger output (TRGO) of tim3, its update event or the reset by tim1 */
+#define DRV_ADC_SCAN_TIMER              TIM3
+#define DRV_ADC_SCAN_TIMER_CLOCK        RCC_APB1Periph_TIM3
+#define DRV_ADC_SCAN_TRIGGER            ADC_ExternalTrigConv_T3_TRGO
+
+/* The external trigger is the trigger output (TRGO) of tim1 (see the pwm1 trigger point), it resets tim3 */
+#define DRV_ADC_SCAN_EXT_SOURCE         TIM_TS_ITR0
+
+enum
+{
+#ifdef MR_BSP_ADC_1
+    DRV_ADC_1_INDEX,
+#endif
+#ifdef MR_BSP_ADC_2
+    DRV_ADC_2_INDEX,
+#endif
+};
+
 static struct drv_adc_data drv_adc_data[] =
     {
 #ifdef MR_BSP_ADC_1
-        {"adc1", ADC1, RCC_APB2Periph_ADC1},
+#if !defined(MR_BSP_TIMER_3) && !defined(MR_BSP_PWM_3)
+        {"adc1", ADC1, RCC_APB2Periph_ADC1, DMA1_Channel1, DMA1_IT_HT1, DMA1_IT_TC1, DMA1_Channel1_IRQn},
+#else
+        /* Tim3 belongs to the timer3 or pwm3 device, the scan has no trigger */
+        {"adc1", ADC1, RCC_APB2Periph_ADC1, MR_NULL, 0, 0, (IRQn_Type)0},
+#endif
 #endif
 #ifdef MR_BSP_ADC_2
-        {"adc2", ADC2, RCC_APB2Periph_ADC2},
+        /* Adc2 has no dma request */
+        {"adc2", ADC2, RCC_APB2Periph_ADC2, MR_NULL, 0, 0, (IRQn_Type)0},
 #endif
     };
 
@@ -126,6 +150,178 @@ static mr_uint32_t drv_adc_read(mr_adc_t adc, mr_off_t channel)
     return ADC_GetConversionValue(adc_data->instance);
 }
 
+static mr_err_t drv_adc_start_scan(mr_adc_t adc, mr_adc_scan_t scan)
+{
+    struct drv_adc_data *adc_data = (struct drv_adc_data *)adc->device.data;
+    ADC_InitTypeDef ADC_InitStructure = {0};
+    DMA_InitTypeDef DMA_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure = {0};
+    RCC_ClocksTypeDef RCC_ClockStructure = {0};
+    mr_uint32_t pclk_freq = 0, ticks = 0, prescaler = 0;
+    mr_uint8_t channel = 0, rank = 0;
+
+    if (adc_data->dma_channel == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    /* The dma transfer count is 16 bits */
+    if (scan->count > MR_UINT16_MAX)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* Sequence the enabled channels in ascending order, the regular sequence holds 16 ranks */
+    for (channel = 0; channel <= 17; channel++)
+    {
+        if (adc->config.channel._mask & (1 << channel))
+        {
+            if (rank == 16)
+            {
+                return MR_ERR_INVALID;
+            }
+            rank++;
+            ADC_RegularChannelConfig(adc_data->instance, channel, rank, ADC_SampleTime_13Cycles5);
+        }
+    }
+    if (rank == 0 || (adc->config.channel._mask >> 18) != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    if (scan->rate != 0)
+    {
+        /* The trigger timer overflows once per scan */
+        RCC_GetClocksFreq(&RCC_ClockStructure);
+        if ((RCC->CFGR0 & RCC_PPRE1) == 0)
+        {
+            pclk_freq = RCC_ClockStructure.PCLK1_Frequency;
+        } else
+        {
+            pclk_freq = 2 * RCC_ClockStructure.PCLK1_Frequency;
+        }
+        ticks = pclk_freq / scan->rate;
+        if (ticks < 2)
+        {
+            return MR_ERR_INVALID;
+        }
+        prescaler = ticks / 65536 + 1;
+
+        RCC_APB1PeriphClockCmd(DRV_ADC_SCAN_TIMER_CLOCK, ENABLE);
+        TIM_Cmd(DRV_ADC_SCAN_TIMER, DISABLE);
+        TIM_TimeBaseInitStructure.TIM_Period = ticks / prescaler - 1;
+        TIM_TimeBaseInitStructure.TIM_Prescaler = prescaler - 1;
+        TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+        TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+        TIM_TimeBaseInit(DRV_ADC_SCAN_TIMER, &TIM_TimeBaseInitStructure);
+        TIM_SelectOutputTrigger(DRV_ADC_SCAN_TIMER, TIM_TRGOSource_Update);
+    } else
+    {
+        /* The reset by tim1 is passed on as the trigger output of tim3 */
+        RCC_APB1PeriphClockCmd(DRV_ADC_SCAN_TIMER_CLOCK, ENABLE);
+        TIM_Cmd(DRV_ADC_SCAN_TIMER, DISABLE);
+        TIM_TimeBaseInitStructure.TIM_Period = 0xffff;
+        TIM_TimeBaseInitStructure.TIM_Prescaler = 0;
+        TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+        TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+        TIM_TimeBaseInit(DRV_ADC_SCAN_TIMER, &TIM_TimeBaseInitStructure);
+        TIM_SelectInputTrigger(DRV_ADC_SCAN_TIMER, DRV_ADC_SCAN_EXT_SOURCE);
+        TIM_SelectSlaveMode(DRV_ADC_SCAN_TIMER, TIM_SlaveMode_Reset);
+        TIM_SelectOutputTrigger(DRV_ADC_SCAN_TIMER, TIM_TRGOSource_Reset);
+    }
+
+    /* Circular dma over both halves, the half and full interrupts hand out the completed half */
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    DMA_DeInit(adc_data->dma_channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&adc_data->instance->RDATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)scan->buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = scan->count;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(adc_data->dma_channel, &DMA_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = adc_data->dma_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    DMA_ITConfig(adc_data->dma_channel, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    DMA_Cmd(adc_data->dma_channel, ENABLE);
+
+    /* One trigger converts the whole sequence */
+    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+    ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = DRV_ADC_SCAN_TRIGGER;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = rank;
+    ADC_Init(adc_data->instance, &ADC_InitStructure);
+    ADC_DMACmd(adc_data->instance, ENABLE);
+    ADC_ExternalTrigConvCmd(adc_data->instance, ENABLE);
+    TIM_Cmd(DRV_ADC_SCAN_TIMER, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static void drv_adc_stop_scan(mr_adc_t adc)
+{
+    struct drv_adc_data *adc_data = (struct drv_adc_data *)adc->device.data;
+    ADC_InitTypeDef ADC_InitStructure = {0};
+
+    if (adc_data->dma_channel == MR_NULL)
+    {
+        return;
+    }
+
+    TIM_Cmd(DRV_ADC_SCAN_TIMER, DISABLE);
+    DRV_ADC_SCAN_TIMER->SMCFGR &= (uint16_t)~TIM_SMS;
+    ADC_ExternalTrigConvCmd(adc_data->instance, DISABLE);
+    ADC_DMACmd(adc_data->instance, DISABLE);
+    DMA_Cmd(adc_data->dma_channel, DISABLE);
+    DMA_ITConfig(adc_data->dma_channel, DMA_IT_HT | DMA_IT_TC, DISABLE);
+
+    /* Back to the single software triggered conversion */
+    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+    ADC_InitStructure.ADC_ScanConvMode = DISABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = 1;
+    ADC_Init(adc_data->instance, &ADC_InitStructure);
+}
+
+static void drv_adc_dma_isr(mr_adc_t adc)
+{
+    struct drv_adc_data *adc_data = (struct drv_adc_data *)adc->device.data;
+
+    if (DMA_GetITStatus(adc_data->dma_it_ht) != RESET)
+    {
+        mr_adc_device_isr(adc, MR_ADC_EVENT_SCAN_HALF);
+        DMA_ClearITPendingBit(adc_data->dma_it_ht);
+    }
+
+    if (DMA_GetITStatus(adc_data->dma_it_tc) != RESET)
+    {
+        mr_adc_device_isr(adc, MR_ADC_EVENT_SCAN_FULL);
+        DMA_ClearITPendingBit(adc_data->dma_it_tc);
+    }
+}
+
+#if defined(MR_BSP_ADC_1) && !defined(MR_BSP_TIMER_3) && !defined(MR_BSP_PWM_3)
+void DMA1_Channel1_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel1_IRQHandler(void)
+{
+    drv_adc_dma_isr(&adc_device[DRV_ADC_1_INDEX]);
+}
+#endif
+
 mr_err_t drv_adc_init(void)
 {
     static struct mr_adc_ops drv_ops =
@@ -133,6 +329,8 @@ mr_err_t drv_adc_init(void)
             drv_adc_configure,
             drv_adc_channel_configure,
             drv_adc_read,
+            drv_adc_start_scan,
+            drv_adc_stop_scan,
         };
     mr_size_t count = mr_array_num(adc_device);
     mr_err_t ret = MR_ERR_OK;
@@ -25,6 +25,11 @@ struct drv_adc_data
 
     ADC_TypeDef *instance;
     mr_uint32_t periph_clock;
+
+    DMA_Channel_TypeDef *dma_channel;
+    mr_uint32_t dma_it_ht;
+    mr_uint32_t dma_it_tc;
+    IRQn_Type dma_irqno;
 };
 
 #endif
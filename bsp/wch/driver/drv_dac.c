@@ -12,13 +12,37 @@
 
 #if (MR_CFG_DAC == MR_CFG_ENABLE)
 
+enum
+{
+#ifdef MR_BSP_DAC_1
+    DRV_DAC_1_INDEX,
+#endif
+#ifdef MR_BSP_DAC_2
+    DRV_DAC_2_INDEX,
+#endif
+};
+
 static struct drv_dac_data drv_dac_data[] =
     {
 #ifdef MR_BSP_DAC_1
-        {"dac1", DAC_Channel_1, RCC_APB1Periph_DAC},
+#if !defined(MR_BSP_UART_4) && !defined(MR_BSP_TIMER_6) && !defined(MR_BSP_PWM_6)
+        {"dac1", DAC_Channel_1, RCC_APB1Periph_DAC, TIM6, RCC_APB1Periph_TIM6, DAC_Trigger_T6_TRGO,
+         (mr_uint32_t)&DAC->R12BDHR1, DMA2_Channel3, DMA2_IT_HT3, DMA2_IT_TC3, DMA2_Channel3_IRQn},
+#else
+        /* Dma2 channel3 belongs to the uart4 receive, or tim6 to the timer6 or pwm6 device */
+        {"dac1", DAC_Channel_1, RCC_APB1Periph_DAC, TIM6, RCC_APB1Periph_TIM6, DAC_Trigger_T6_TRGO,
+         (mr_uint32_t)&DAC->R12BDHR1, MR_NULL, 0, 0, (IRQn_Type)0},
+#endif
 #endif
 #ifdef MR_BSP_DAC_2
-        {"dac2", DAC_Channel_2, RCC_APB1Periph_DAC},
+#if !defined(MR_BSP_TIMER_7) && !defined(MR_BSP_PWM_7)
+        {"dac2", DAC_Channel_2, RCC_APB1Periph_DAC, TIM7, RCC_APB1Periph_TIM7, DAC_Trigger_T7_TRGO,
+         (mr_uint32_t)&DAC->R12BDHR2, DMA2_Channel4, DMA2_IT_HT4, DMA2_IT_TC4, DMA2_Channel4_IRQn},
+#else
+        /* Tim7 belongs to the timer7 or pwm7 device */
+        {"dac2", DAC_Channel_2, RCC_APB1Periph_DAC, TIM7, RCC_APB1Periph_TIM7, DAC_Trigger_T7_TRGO,
+         (mr_uint32_t)&DAC->R12BDHR2, MR_NULL, 0, 0, (IRQn_Type)0},
+#endif
 #endif
     };
 
@@ -109,6 +133,147 @@ static void drv_dac_write(mr_dac_t dac, mr_off_t channel, mr_uint32_t value)
     }
 }
 
+static mr_err_t drv_dac_start_stream(mr_dac_t dac, mr_dac_stream_t stream)
+{
+    struct drv_dac_data *dac_data = (struct drv_dac_data *)dac->device.data;
+    DAC_InitTypeDef DAC_InitStructure = {0};
+    DMA_InitTypeDef DMA_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure = {0};
+    RCC_ClocksTypeDef RCC_ClockStructure = {0};
+    mr_uint32_t pclk_freq = 0, ticks = 0, prescaler = 0;
+
+    if (dac_data->dma_channel == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    /* The dma transfer count is 16 bits */
+    if (stream->count > MR_UINT16_MAX)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* The trigger timer overflows once per sample */
+    RCC_GetClocksFreq(&RCC_ClockStructure);
+    if ((RCC->CFGR0 & RCC_PPRE1) == 0)
+    {
+        pclk_freq = RCC_ClockStructure.PCLK1_Frequency;
+    } else
+    {
+        pclk_freq = 2 * RCC_ClockStructure.PCLK1_Frequency;
+    }
+    ticks = pclk_freq / stream->rate;
+    if (ticks < 2)
+    {
+        return MR_ERR_INVALID;
+    }
+    prescaler = ticks / 65536 + 1;
+
+    RCC_APB1PeriphClockCmd(dac_data->timer_periph_clock, ENABLE);
+    TIM_Cmd(dac_data->timer, DISABLE);
+    TIM_TimeBaseInitStructure.TIM_Period = ticks / prescaler - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = prescaler - 1;
+    TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInit(dac_data->timer, &TIM_TimeBaseInitStructure);
+    TIM_SelectOutputTrigger(dac_data->timer, TIM_TRGOSource_Update);
+
+    /* Circular dma over both halves, the half and full interrupts ask for a refill */
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA2, ENABLE);
+    DMA_DeInit(dac_data->dma_channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = dac_data->data_address;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)stream->buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = stream->count;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(dac_data->dma_channel, &DMA_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = dac_data->dma_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    DMA_ITConfig(dac_data->dma_channel, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    DMA_Cmd(dac_data->dma_channel, ENABLE);
+
+    /* Each trigger moves the next sample to the output */
+    DAC_InitStructure.DAC_Trigger = dac_data->trigger;
+    DAC_InitStructure.DAC_WaveGeneration = DAC_WaveGeneration_None;
+    DAC_InitStructure.DAC_LFSRUnmask_TriangleAmplitude = DAC_LFSRUnmask_Bit0;
+    DAC_InitStructure.DAC_OutputBuffer = DAC_OutputBuffer_Disable;
+    DAC_Init(dac_data->channel, &DAC_InitStructure);
+    DAC_Cmd(dac_data->channel, ENABLE);
+    DAC_DMACmd(dac_data->channel, ENABLE);
+
+    TIM_Cmd(dac_data->timer, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static void drv_dac_stop_stream(mr_dac_t dac)
+{
+    struct drv_dac_data *dac_data = (struct drv_dac_data *)dac->device.data;
+    DAC_InitTypeDef DAC_InitStructure = {0};
+
+    if (dac_data->dma_channel == MR_NULL)
+    {
+        return;
+    }
+
+    TIM_Cmd(dac_data->timer, DISABLE);
+    DAC_DMACmd(dac_data->channel, DISABLE);
+    DMA_Cmd(dac_data->dma_channel, DISABLE);
+    DMA_ITConfig(dac_data->dma_channel, DMA_IT_HT | DMA_IT_TC, DISABLE);
+
+    /* Back to the direct write */
+    DAC_InitStructure.DAC_Trigger = DAC_Trigger_None;
+    DAC_InitStructure.DAC_WaveGeneration = DAC_WaveGeneration_None;
+    DAC_InitStructure.DAC_LFSRUnmask_TriangleAmplitude = DAC_LFSRUnmask_Bit0;
+    DAC_InitStructure.DAC_OutputBuffer = DAC_OutputBuffer_Disable;
+    DAC_Init(dac_data->channel, &DAC_InitStructure);
+    DAC_Cmd(dac_data->channel, ENABLE);
+}
+
+static void drv_dac_dma_isr(mr_dac_t dac)
+{
+    struct drv_dac_data *dac_data = (struct drv_dac_data *)dac->device.data;
+
+    if (DMA_GetITStatus(dac_data->dma_it_ht) != RESET)
+    {
+        mr_dac_device_isr(dac, MR_DAC_EVENT_STREAM_HALF);
+        DMA_ClearITPendingBit(dac_data->dma_it_ht);
+    }
+
+    if (DMA_GetITStatus(dac_data->dma_it_tc) != RESET)
+    {
+        mr_dac_device_isr(dac, MR_DAC_EVENT_STREAM_FULL);
+        DMA_ClearITPendingBit(dac_data->dma_it_tc);
+    }
+}
+
+#if defined(MR_BSP_DAC_1) && !defined(MR_BSP_UART_4) && !defined(MR_BSP_TIMER_6) && !defined(MR_BSP_PWM_6)
+void DMA2_Channel3_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA2_Channel3_IRQHandler(void)
+{
+    drv_dac_dma_isr(&dac_device[DRV_DAC_1_INDEX]);
+}
+#endif
+
+#if defined(MR_BSP_DAC_2) && !defined(MR_BSP_TIMER_7) && !defined(MR_BSP_PWM_7)
+void DMA2_Channel4_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA2_Channel4_IRQHandler(void)
+{
+    drv_dac_dma_isr(&dac_device[DRV_DAC_2_INDEX]);
+}
+#endif
+
 mr_err_t drv_dac_init(void)
 {
     static struct mr_dac_ops drv_ops =
@@ -116,6 +281,8 @@ mr_err_t drv_dac_init(void)
             drv_dac_configure,
             drv_dac_channel_configure,
             drv_dac_write,
+            drv_dac_start_stream,
+            drv_dac_stop_stream,
         };
     mr_size_t count = mr_array_num(dac_device);
     mr_err_t ret = MR_ERR_OK;
@@ -25,6 +25,15 @@ struct drv_dac_data
 
     mr_uint32_t channel;
     mr_uint32_t periph_clock;
+
+    TIM_TypeDef *timer;
+    mr_uint32_t timer_periph_clock;
+    mr_uint32_t trigger;
+    mr_uint32_t data_address;
+    DMA_Channel_TypeDef *dma_channel;
+    mr_uint32_t dma_it_ht;
+    mr_uint32_t dma_it_tc;
+    IRQn_Type dma_irqno;
 };
 
 #endif
@@ -211,98 +211,90 @@ static void drv_pin_write(mr_pin_t pin, mr_off_t number, mr_level_t level)
     GPIO_WriteBit(PIN_STPORT(number), PIN_STPIN(number), (BitAction)level);
 }
 
-void EXTI0_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+static mr_uint32_t drv_pin_port_read(mr_pin_t pin, mr_off_t port)
+{
+    if (port >= MR_BSP_PIN_NUMBER / 16)
+    {
+        return 0;
+    }
 
-void EXTI0_IRQHandler(void)
+    return GPIO_ReadInputData(PIN_STPORT(port << 4));
+}
+
+static void drv_pin_port_write_masked(mr_pin_t pin, mr_off_t port, mr_uint32_t set, mr_uint32_t clear)
+{
+    if (port >= MR_BSP_PIN_NUMBER / 16)
+    {
+        return;
+    }
+
+    /* One store sets and clears the pins, set wins */
+    PIN_STPORT(port << 4)->BSHR = (set & 0xffffu) | ((clear & 0xffffu) << 16);
+}
+
+static void drv_pin_isr(mr_uint32_t lines)
 {
-    if (EXTI_GetITStatus(EXTI_Line0) != RESET)
+    mr_uint32_t pending = EXTI->INTFR & EXTI->INTENR & lines;
+    mr_uint32_t line = 0;
+
+    /* Walk only the pending lines, lowest first (count trailing zeros) */
+    while (pending != 0)
     {
-        mr_pin_device_isr(&pin_device, irq_mask[0]);
-        EXTI_ClearITPendingBit(EXTI_Line0);
+        line = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        EXTI_ClearITPendingBit(1u << line);
+        mr_pin_device_isr(&pin_device, irq_mask[line]);
     }
 }
 
+void EXTI0_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+
+void EXTI0_IRQHandler(void)
+{
+    drv_pin_isr(EXTI_Line0);
+}
+
 void EXTI1_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 
 void EXTI1_IRQHandler(void)
 {
-    if (EXTI_GetITStatus(EXTI_Line1) != RESET)
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[1]);
-        EXTI_ClearITPendingBit(EXTI_Line1);
-    }
+    drv_pin_isr(EXTI_Line1);
 }
 
 void EXTI2_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 
 void EXTI2_IRQHandler(void)
 {
-    if (EXTI_GetITStatus(EXTI_Line2) != RESET)
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[2]);
-        EXTI_ClearITPendingBit(EXTI_Line2);
-    }
+    drv_pin_isr(EXTI_Line2);
 }
 
 void EXTI3_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 
 void EXTI3_IRQHandler(void)
 {
-    if (EXTI_GetITStatus(EXTI_Line3) != RESET)
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[3]);
-        EXTI_ClearITPendingBit(EXTI_Line3);
-    }
+    drv_pin_isr(EXTI_Line3);
 }
 
 void EXTI4_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 
 void EXTI4_IRQHandler(void)
 {
-    if (EXTI_GetITStatus(EXTI_Line4) != RESET)
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[4]);
-        EXTI_ClearITPendingBit(EXTI_Line4);
-    }
+    drv_pin_isr(EXTI_Line4);
 }
 
 void EXTI9_5_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 
 void EXTI9_5_IRQHandler(void)
 {
-    if ((EXTI_GetITStatus(EXTI_Line5) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line6) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line7) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line8) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line9) != RESET))
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[5]);
-        mr_pin_device_isr(&pin_device, irq_mask[6]);
-        mr_pin_device_isr(&pin_device, irq_mask[7]);
-        mr_pin_device_isr(&pin_device, irq_mask[8]);
-        mr_pin_device_isr(&pin_device, irq_mask[9]);
-        EXTI_ClearITPendingBit(EXTI_Line5 | EXTI_Line6 | EXTI_Line7 | EXTI_Line8 | EXTI_Line9);
-    }
+    drv_pin_isr(EXTI_Line5 | EXTI_Line6 | EXTI_Line7 | EXTI_Line8 | EXTI_Line9);
 }
 
 void EXTI15_10_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 
 void EXTI15_10_IRQHandler(void)
 {
-    if ((EXTI_GetITStatus(EXTI_Line10) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line11) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line12) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line13) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line14) != RESET)
-        || (EXTI_GetITStatus(EXTI_Line15) != RESET))
-    {
-        mr_pin_device_isr(&pin_device, irq_mask[10]);
-        mr_pin_device_isr(&pin_device, irq_mask[11]);
-        mr_pin_device_isr(&pin_device, irq_mask[12]);
-        mr_pin_device_isr(&pin_device, irq_mask[13]);
-        mr_pin_device_isr(&pin_device, irq_mask[14]);
-        EXTI_ClearITPendingBit(EXTI_Line10 | EXTI_Line11 | EXTI_Line12 | EXTI_Line13 | EXTI_Line14 | EXTI_Line15);
-    }
+    drv_pin_isr(EXTI_Line10 | EXTI_Line11 | EXTI_Line12 | EXTI_Line13 | EXTI_Line14 | EXTI_Line15);
 }
 
 mr_err_t drv_gpio_init(void)
@@ -312,6 +304,8 @@ mr_err_t drv_gpio_init(void)
             drv_pin_configure,
             drv_pin_read,
             drv_pin_write,
+            drv_pin_port_read,
+            drv_pin_port_write_masked,
         };
     mr_err_t ret = MR_ERR_OK;
 
@@ -59,7 +59,7 @@ static mr_level_t drv_soft_i2c_bus_sda_read(mr_soft_i2c_bus_t i2c_bus)
 {
     struct drv_soft_i2c_bus_data *soft_i2c_bus_data = (struct drv_soft_i2c_bus_data *)i2c_bus->i2c_bus.device.data;
 
-    return GPIO_ReadOutputDataBit(soft_i2c_bus_data->gpio_port, soft_i2c_bus_data->sda_gpio_pin);
+    return GPIO_ReadInputDataBit(soft_i2c_bus_data->gpio_port, soft_i2c_bus_data->sda_gpio_pin);
 }
 
 mr_err_t drv_soft_i2c_bus_init(void)
@@ -87,4 +87,493 @@ mr_err_t drv_soft_i2c_bus_init(void)
 }
 MR_INIT_DRIVER_EXPORT(drv_soft_i2c_bus_init);
 
+enum drv_i2c_index
+{
+#ifdef MR_BSP_HW_I2C_1
+    DRV_I2C_1_INDEX,
+#endif
+#ifdef MR_BSP_HW_I2C_2
+    DRV_I2C_2_INDEX,
+#endif
+};
+
+static struct drv_i2c_bus_data drv_i2c_bus_data[] =
+    {
+#ifdef MR_BSP_HW_I2C_1
+        {"hi2c1", I2C1, RCC_APB1Periph_I2C1, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_6, GPIO_Pin_7, I2C1_EV_IRQn,
+         I2C1_ER_IRQn},
+#endif
+#ifdef MR_BSP_HW_I2C_2
+        {"hi2c2", I2C2, RCC_APB1Periph_I2C2, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_10, GPIO_Pin_11, I2C2_EV_IRQn,
+         I2C2_ER_IRQn},
+#endif
+    };
+
+static struct drv_i2c_bus i2c_bus_device[mr_array_num(drv_i2c_bus_data)];
+
+static mr_err_t drv_i2c_configure(mr_i2c_bus_t i2c_bus, mr_i2c_config_t config)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)i2c_bus->device.data;
+    struct drv_i2c_bus *drv_i2c_bus = (struct drv_i2c_bus *)i2c_bus;
+    mr_i2c_device_t i2c_device = (mr_i2c_device_t)mr_mutex_get_owner(&i2c_bus->lock);
+    GPIO_InitTypeDef GPIO_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+    I2C_InitTypeDef I2C_InitStructure = {0};
+    mr_state_t state = (config->baud_rate != 0) ? MR_ENABLE : MR_DISABLE;
+
+    /* The peripheral runs the standard and the fast mode */
+    if (config->baud_rate > MR_I2C_BAUD_RATE_FAST)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* The slave answers on the address of the device taking the bus */
+    if (state == MR_ENABLE && config->host_slave == MR_I2C_SLAVE && i2c_device == MR_NULL)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    RCC_APB1PeriphClockCmd(i2c_bus_data->i2c_periph_clock, ENABLE);
+    RCC_APB2PeriphClockCmd(i2c_bus_data->gpio_periph_clock | RCC_APB2Periph_AFIO, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = i2c_bus_data->scl_gpio_pin | i2c_bus_data->sda_gpio_pin;
+    GPIO_InitStructure.GPIO_Mode = (state == MR_ENABLE) ? GPIO_Mode_AF_OD : GPIO_Mode_IN_FLOATING;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(i2c_bus_data->gpio_port, &GPIO_InitStructure);
+
+    /* Any transfer in progress is dropped */
+    I2C_ITConfig(i2c_bus_data->instance, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
+    I2C_Cmd(i2c_bus_data->instance, DISABLE);
+    drv_i2c_bus->result = MR_ERR_OK;
+
+    NVIC_InitStructure.NVIC_IRQChannel = i2c_bus_data->ev_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = state;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = i2c_bus_data->er_irqno;
+    NVIC_Init(&NVIC_InitStructure);
+
+    if (state == MR_DISABLE)
+    {
+        return MR_ERR_OK;
+    }
+
+    if (config->host_slave == MR_I2C_SLAVE)
+    {
+        if (config->addr_bits == MR_I2C_ADDR_BITS_10)
+        {
+            I2C_InitStructure.I2C_OwnAddress1 = (mr_uint16_t)i2c_device->address;
+            I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_10bit;
+        } else
+        {
+            I2C_InitStructure.I2C_OwnAddress1 = (mr_uint16_t)(i2c_device->address << 1);
+            I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+        }
+    } else
+    {
+        I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+    }
+    I2C_InitStructure.I2C_ClockSpeed = config->baud_rate;
+    I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+    I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+    I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+    I2C_Init(i2c_bus_data->instance, &I2C_InitStructure);
+    I2C_Cmd(i2c_bus_data->instance, ENABLE);
+
+    /* The slave is served by the interrupts all along, the host enables them per transfer */
+    if (config->host_slave == MR_I2C_SLAVE)
+    {
+        I2C_ITConfig(i2c_bus_data->instance, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+    }
+
+    return MR_ERR_OK;
+}
+
+static mr_err_t drv_i2c_write(mr_i2c_bus_t i2c_bus, mr_uint8_t data)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)i2c_bus->device.data;
+
+    /* Slave transmit, called on MR_I2C_BUS_EVENT_TX_INT with the data register empty */
+    I2C_SendData(i2c_bus_data->instance, data);
+    return MR_ERR_OK;
+}
+
+static mr_uint8_t drv_i2c_read(mr_i2c_bus_t i2c_bus, mr_state_t ack)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)i2c_bus->device.data;
+
+    /* Slave receive, called on MR_I2C_BUS_EVENT_RX_INT with the data register full */
+    return I2C_ReceiveData(i2c_bus_data->instance);
+}
+
+static void drv_i2c_finish(struct drv_i2c_bus *drv_i2c_bus, mr_err_t result)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+
+    I2C_ITConfig(i2c_bus_data->instance, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
+    I2C_NACKPositionConfig(i2c_bus_data->instance, I2C_NACKPosition_Current);
+    I2C_AcknowledgeConfig(i2c_bus_data->instance, ENABLE);
+    drv_i2c_bus->result = result;
+
+    mr_i2c_bus_isr(&drv_i2c_bus->i2c_bus,
+                   (result == MR_ERR_OK) ? MR_I2C_BUS_EVENT_XFER_DONE : MR_I2C_BUS_EVENT_XFER_ERR);
+}
+
+static void drv_i2c_end_msg(struct drv_i2c_bus *drv_i2c_bus)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+
+    /* The last message stops the transaction, the others restart it for the next message */
+    if (drv_i2c_bus->index + 1 == drv_i2c_bus->number)
+    {
+        I2C_GenerateSTOP(i2c_bus_data->instance, ENABLE);
+    } else
+    {
+        I2C_GenerateSTART(i2c_bus_data->instance, ENABLE);
+        drv_i2c_bus->restart = MR_TRUE;
+    }
+}
+
+static void drv_i2c_next_msg(struct drv_i2c_bus *drv_i2c_bus)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+
+    drv_i2c_bus->index++;
+    drv_i2c_bus->count = 0;
+    if (drv_i2c_bus->index == drv_i2c_bus->number)
+    {
+        drv_i2c_finish(drv_i2c_bus, MR_ERR_OK);
+        return;
+    }
+
+    /* A write continued without start keeps loading the data register */
+    if (drv_i2c_bus->msgs[drv_i2c_bus->index].flags & MR_I2C_M_NO_START)
+    {
+        I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, ENABLE);
+    }
+}
+
+static void drv_i2c_host_isr(struct drv_i2c_bus *drv_i2c_bus, mr_uint16_t star1)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+    mr_i2c_msg_t msg = &drv_i2c_bus->msgs[drv_i2c_bus->index];
+    mr_uint8_t *buffer = (mr_uint8_t *)msg->buffer;
+    mr_size_t remain = msg->size - drv_i2c_bus->count;
+
+    /* Start sent, reading star1 then writing the address clears it */
+    if (star1 & I2C_STAR1_SB)
+    {
+        drv_i2c_bus->restart = MR_FALSE;
+        I2C_SendData(i2c_bus_data->instance,
+                     (mr_uint8_t)((drv_i2c_bus->i2c_device->address << 1) | (msg->flags & MR_I2C_M_RD)));
+        return;
+    }
+
+    /* The byte transfer finished of the last write holds until the repeated start is sent */
+    if (drv_i2c_bus->restart == MR_TRUE)
+    {
+        return;
+    }
+
+    /* Address acknowledged, the acknowledge of the reads is set up before reading star2 clears it */
+    if (star1 & I2C_STAR1_ADDR)
+    {
+        if ((msg->flags & MR_I2C_M_RD) == 0)
+        {
+            (void)i2c_bus_data->instance->STAR2;
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, ENABLE);
+        } else if (msg->size == 1)
+        {
+            I2C_AcknowledgeConfig(i2c_bus_data->instance, DISABLE);
+            (void)i2c_bus_data->instance->STAR2;
+            drv_i2c_end_msg(drv_i2c_bus);
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, ENABLE);
+        } else if (msg->size == 2)
+        {
+            /* The nack goes to the byte in the shift register, both bytes are read on byte transfer finished */
+            I2C_AcknowledgeConfig(i2c_bus_data->instance, DISABLE);
+            I2C_NACKPositionConfig(i2c_bus_data->instance, I2C_NACKPosition_Next);
+            (void)i2c_bus_data->instance->STAR2;
+        } else
+        {
+            I2C_AcknowledgeConfig(i2c_bus_data->instance, ENABLE);
+            (void)i2c_bus_data->instance->STAR2;
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, (msg->size > 3) ? ENABLE : DISABLE);
+        }
+        return;
+    }
+
+    if (msg->flags & MR_I2C_M_RD)
+    {
+        if (msg->size == 1 && (star1 & I2C_STAR1_RXNE))
+        {
+            buffer[drv_i2c_bus->count++] = I2C_ReceiveData(i2c_bus_data->instance);
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, DISABLE);
+            drv_i2c_next_msg(drv_i2c_bus);
+        } else if (remain > 3 && (star1 & I2C_STAR1_RXNE))
+        {
+            /* The last 3 bytes are taken on byte transfer finished, with the bus held */
+            buffer[drv_i2c_bus->count++] = I2C_ReceiveData(i2c_bus_data->instance);
+            if (remain == 4)
+            {
+                I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, DISABLE);
+            }
+        } else if (remain == 3 && (star1 & I2C_STAR1_BTF))
+        {
+            I2C_AcknowledgeConfig(i2c_bus_data->instance, DISABLE);
+            buffer[drv_i2c_bus->count++] = I2C_ReceiveData(i2c_bus_data->instance);
+        } else if (remain == 2 && (star1 & I2C_STAR1_BTF))
+        {
+            drv_i2c_end_msg(drv_i2c_bus);
+            buffer[drv_i2c_bus->count++] = I2C_ReceiveData(i2c_bus_data->instance);
+            buffer[drv_i2c_bus->count++] = I2C_ReceiveData(i2c_bus_data->instance);
+            I2C_NACKPositionConfig(i2c_bus_data->instance, I2C_NACKPosition_Current);
+            I2C_AcknowledgeConfig(i2c_bus_data->instance, ENABLE);
+            drv_i2c_next_msg(drv_i2c_bus);
+        }
+    } else
+    {
+        if (remain != 0 && (star1 & I2C_STAR1_TXE))
+        {
+            /* The last byte is awaited on byte transfer finished */
+            I2C_SendData(i2c_bus_data->instance, buffer[drv_i2c_bus->count++]);
+            if (remain == 1)
+            {
+                I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, DISABLE);
+            }
+        } else if (remain == 0 && (star1 & (I2C_STAR1_BTF | I2C_STAR1_TXE)))
+        {
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, DISABLE);
+            if (drv_i2c_bus->index + 1 == drv_i2c_bus->number
+                || (drv_i2c_bus->msgs[drv_i2c_bus->index + 1].flags & MR_I2C_M_NO_START) == 0)
+            {
+                drv_i2c_end_msg(drv_i2c_bus);
+            }
+            drv_i2c_next_msg(drv_i2c_bus);
+        }
+    }
+}
+
+static void drv_i2c_slave_isr(struct drv_i2c_bus *drv_i2c_bus, mr_uint16_t star1)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+    mr_uint16_t star2 = 0;
+
+    /* Address matched, reading star2 clears it and tells the direction */
+    if (star1 & I2C_STAR1_ADDR)
+    {
+        star2 = i2c_bus_data->instance->STAR2;
+        I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, ENABLE);
+        mr_i2c_bus_isr(&drv_i2c_bus->i2c_bus,
+                       MR_I2C_BUS_EVENT_ADDR_INT | ((star2 & I2C_STAR2_TRA) ? MR_I2C_M_RD : MR_I2C_M_WR));
+        return;
+    }
+
+    if (star1 & I2C_STAR1_RXNE)
+    {
+        mr_i2c_bus_isr(&drv_i2c_bus->i2c_bus, MR_I2C_BUS_EVENT_RX_INT);
+    } else if ((star1 & I2C_STAR1_TXE) && (i2c_bus_data->instance->STAR2 & I2C_STAR2_TRA))
+    {
+        mr_i2c_bus_isr(&drv_i2c_bus->i2c_bus, MR_I2C_BUS_EVENT_TX_INT);
+    }
+
+    /* Stop detected, writing ctlr1 after reading star1 clears it */
+    if (star1 & I2C_STAR1_STOPF)
+    {
+        I2C_Cmd(i2c_bus_data->instance, ENABLE);
+        I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, DISABLE);
+        mr_i2c_bus_isr(&drv_i2c_bus->i2c_bus, MR_I2C_BUS_EVENT_STOP_INT);
+    }
+}
+
+static void drv_i2c_ev_isr(struct drv_i2c_bus *drv_i2c_bus)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+    mr_uint16_t star1 = i2c_bus_data->instance->STAR1;
+
+    if (drv_i2c_bus->i2c_bus.config.host_slave == MR_I2C_SLAVE)
+    {
+        drv_i2c_slave_isr(drv_i2c_bus, star1);
+    } else if (drv_i2c_bus->result == MR_ERR_BUSY)
+    {
+        drv_i2c_host_isr(drv_i2c_bus, star1);
+    }
+}
+
+static void drv_i2c_er_isr(struct drv_i2c_bus *drv_i2c_bus)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)drv_i2c_bus->i2c_bus.device.data;
+    mr_uint16_t star1 = i2c_bus_data->instance->STAR1;
+
+    I2C_ClearFlag(i2c_bus_data->instance, I2C_FLAG_BERR | I2C_FLAG_ARLO | I2C_FLAG_AF | I2C_FLAG_OVR);
+
+    if (drv_i2c_bus->i2c_bus.config.host_slave == MR_I2C_SLAVE)
+    {
+        /* The host nacks the last byte it reads, which ends the slave transmission */
+        if (star1 & I2C_STAR1_AF)
+        {
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_BUF, DISABLE);
+            mr_i2c_bus_isr(&drv_i2c_bus->i2c_bus, MR_I2C_BUS_EVENT_STOP_INT);
+        }
+    } else if (drv_i2c_bus->result == MR_ERR_BUSY)
+    {
+        /* A nack is stopped by the host, a lost arbitration has released the bus already */
+        if (star1 & I2C_STAR1_AF)
+        {
+            I2C_GenerateSTOP(i2c_bus_data->instance, ENABLE);
+        }
+        drv_i2c_finish(drv_i2c_bus, MR_ERR_IO);
+    }
+}
+
+static mr_err_t drv_i2c_start_xfer(mr_i2c_bus_t i2c_bus, mr_i2c_device_t i2c_device, mr_i2c_msg_t msgs,
+                                   mr_size_t number)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)i2c_bus->device.data;
+    struct drv_i2c_bus *drv_i2c_bus = (struct drv_i2c_bus *)i2c_bus;
+    mr_size_t count = 0;
+
+    if (number == 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* 10bit addresses and reads continued without start are not supported */
+    if (i2c_device->config.addr_bits == MR_I2C_ADDR_BITS_10)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+    for (count = 0; count < number; count++)
+    {
+        if ((msgs[count].flags & MR_I2C_M_ADDR_10BIT)
+            || ((msgs[count].flags & MR_I2C_M_RD) && msgs[count].size == 0)
+            || (count != 0 && (msgs[count].flags & MR_I2C_M_NO_START)
+                && ((msgs[count].flags | msgs[count - 1].flags) & MR_I2C_M_RD)))
+        {
+            return MR_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (drv_i2c_bus->result == MR_ERR_BUSY)
+    {
+        return MR_ERR_BUSY;
+    }
+    drv_i2c_bus->i2c_device = i2c_device;
+    drv_i2c_bus->msgs = msgs;
+    drv_i2c_bus->number = number;
+    drv_i2c_bus->index = 0;
+    drv_i2c_bus->count = 0;
+    drv_i2c_bus->restart = MR_FALSE;
+    drv_i2c_bus->result = MR_ERR_BUSY;
+
+    /* The interrupts run the transfer from the start condition on */
+    I2C_AcknowledgeConfig(i2c_bus_data->instance, ENABLE);
+    I2C_ITConfig(i2c_bus_data->instance, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+    I2C_GenerateSTART(i2c_bus_data->instance, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static mr_ssize_t drv_i2c_xfer(mr_i2c_bus_t i2c_bus, mr_i2c_device_t i2c_device, mr_i2c_msg_t msgs,
+                               mr_size_t number)
+{
+    struct drv_i2c_bus_data *i2c_bus_data = (struct drv_i2c_bus_data *)i2c_bus->device.data;
+    struct drv_i2c_bus *drv_i2c_bus = (struct drv_i2c_bus *)i2c_bus;
+    mr_uint32_t bytes = 0, timeout = 0, tick = mr_delay_ns_to_tick(1000);
+    mr_size_t count = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    ret = drv_i2c_start_xfer(i2c_bus, i2c_device, msgs, number);
+    if (ret != MR_ERR_OK)
+    {
+        return ret;
+    }
+
+    /* Twice the time of 9 clocks per byte and address, and 1ms for the clock stretching */
+    for (count = 0; count < number; count++)
+    {
+        bytes += msgs[count].size + 1;
+    }
+    timeout = (mr_uint32_t)((mr_uint64_t)bytes * 9 * 2 * 1000000u / i2c_bus->config.baud_rate) + 1000;
+
+    /* Wait for the interrupts to finish the transfer */
+    while (drv_i2c_bus->result == MR_ERR_BUSY)
+    {
+        if (timeout-- == 0)
+        {
+            I2C_ITConfig(i2c_bus_data->instance, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
+            I2C_GenerateSTOP(i2c_bus_data->instance, ENABLE);
+            I2C_NACKPositionConfig(i2c_bus_data->instance, I2C_NACKPosition_Current);
+            I2C_AcknowledgeConfig(i2c_bus_data->instance, ENABLE);
+            drv_i2c_bus->result = MR_ERR_TIMEOUT;
+            break;
+        }
+        mr_delay_tick(tick);
+    }
+
+    if (drv_i2c_bus->result != MR_ERR_OK)
+    {
+        return drv_i2c_bus->result;
+    }
+    return (mr_ssize_t)number;
+}
+
+#ifdef MR_BSP_HW_I2C_1
+void I2C1_EV_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void I2C1_EV_IRQHandler(void)
+{
+    drv_i2c_ev_isr(&i2c_bus_device[DRV_I2C_1_INDEX]);
+}
+
+void I2C1_ER_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void I2C1_ER_IRQHandler(void)
+{
+    drv_i2c_er_isr(&i2c_bus_device[DRV_I2C_1_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_HW_I2C_2
+void I2C2_EV_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void I2C2_EV_IRQHandler(void)
+{
+    drv_i2c_ev_isr(&i2c_bus_device[DRV_I2C_2_INDEX]);
+}
+
+void I2C2_ER_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void I2C2_ER_IRQHandler(void)
+{
+    drv_i2c_er_isr(&i2c_bus_device[DRV_I2C_2_INDEX]);
+}
+#endif
+
+mr_err_t drv_i2c_bus_init(void)
+{
+    static struct mr_i2c_bus_ops drv_ops =
+        {
+            drv_i2c_configure,
+            MR_NULL,
+            MR_NULL,
+            drv_i2c_write,
+            drv_i2c_read,
+            drv_i2c_xfer,
+            drv_i2c_start_xfer,
+        };
+    mr_size_t count = mr_array_num(i2c_bus_device);
+    mr_err_t ret = MR_ERR_OK;
+
+    while (count--)
+    {
+        i2c_bus_device[count].result = MR_ERR_OK;
+        ret = mr_i2c_bus_add(&i2c_bus_device[count].i2c_bus,
+                             drv_i2c_bus_data[count].name,
+                             &drv_ops,
+                             &drv_i2c_bus_data[count]);
+        MR_ASSERT(ret == MR_ERR_OK);
+    }
+
+    return ret;
+}
+MR_INIT_DRIVER_EXPORT(drv_i2c_bus_init);
+
 #endif
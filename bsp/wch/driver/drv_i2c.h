@@ -29,6 +29,39 @@ struct drv_soft_i2c_bus_data
     mr_uint16_t sda_gpio_pin;
 };
 
+/**
+ * @struct Driver i2c bus data
+ */
+struct drv_i2c_bus_data
+{
+    const char *name;
+
+    I2C_TypeDef *instance;
+    mr_uint32_t i2c_periph_clock;
+    mr_uint32_t gpio_periph_clock;
+    GPIO_TypeDef *gpio_port;
+    mr_uint16_t scl_gpio_pin;
+    mr_uint16_t sda_gpio_pin;
+    IRQn_Type ev_irqno;
+    IRQn_Type er_irqno;
+};
+
+/**
+ * @struct Driver i2c bus
+ */
+struct drv_i2c_bus
+{
+    struct mr_i2c_bus i2c_bus;
+
+    mr_i2c_device_t i2c_device;
+    mr_i2c_msg_t msgs;
+    mr_size_t number;
+    mr_size_t index;
+    mr_size_t count;
+    mr_bool_t restart;
+    volatile mr_err_t result;
+};
+
 #endif
 
 #endif /* _DRV_I2C_H_ */
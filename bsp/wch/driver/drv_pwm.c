@@ -29,6 +29,12 @@ enum
 #ifdef MR_BSP_PWM_5
     CH32_PWM_5_INDEX,
 #endif
+#ifdef MR_BSP_PWM_6
+    CH32_PWM_6_INDEX,
+#endif
+#ifdef MR_BSP_PWM_7
+    CH32_PWM_7_INDEX,
+#endif
 #ifdef MR_BSP_PWM_8
     CH32_PWM_8_INDEX,
 #endif
@@ -44,21 +50,30 @@ static struct ch32_pwm_data ch32_pwm_data[] =
     {
 #ifdef MR_BSP_PWM_1
         {"pwm1", TIM1, RCC_APB2Periph_TIM1, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_8, GPIO_Pin_9, GPIO_Pin_10,
-         GPIO_Pin_11},
+         GPIO_Pin_11, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_13, GPIO_Pin_14, GPIO_Pin_15, GPIO_Pin_12},
 #endif
 #ifdef MR_BSP_PWM_2
+#ifndef MR_BSP_SPI_1
+        {"pwm2", TIM2, RCC_APB1Periph_TIM2, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_0, GPIO_Pin_1, GPIO_Pin_2,
+         GPIO_Pin_3, 0, MR_NULL, 0, 0, 0, 0, RCC_AHBPeriph_DMA1, DMA1_Channel2, DMA1_IT_TC2, DMA1_Channel2_IRQn},
+#else
+        /* Dma1 channel2 belongs to the spi1 receive */
         {"pwm2", TIM2, RCC_APB1Periph_TIM2, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_0, GPIO_Pin_1, GPIO_Pin_2,
          GPIO_Pin_3},
 #endif
+#endif
 #ifdef MR_BSP_PWM_3
         {"pwm3", TIM3, RCC_APB1Periph_TIM3, RCC_APB2Periph_GPIOA | RCC_APB2Periph_GPIOB, GPIOA, GPIO_Pin_6,
          GPIO_Pin_7,},
 #endif
 #ifdef MR_BSP_PWM_4
-        {"pwm4", TIM4, RCC_APB1Periph_TIM4, RCC_APB2Periph_GPIOD},
+        {"pwm4", TIM4, RCC_APB1Periph_TIM4, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_6, GPIO_Pin_7, GPIO_Pin_8,
+         GPIO_Pin_9, 0, MR_NULL, 0, 0, 0, 0, RCC_AHBPeriph_DMA1, DMA1_Channel7, DMA1_IT_TC7, DMA1_Channel7_IRQn},
 #endif
 #ifdef MR_BSP_PWM_5
-        {"pwm5", TIM5, RCC_APB1Periph_TIM5},
+        /* Shares pa0-pa3 with pwm2 */
+        {"pwm5", TIM5, RCC_APB1Periph_TIM5, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_0, GPIO_Pin_1, GPIO_Pin_2,
+         GPIO_Pin_3, 0, MR_NULL, 0, 0, 0, 0, RCC_AHBPeriph_DMA2, DMA2_Channel2, DMA2_IT_TC2, DMA2_Channel2_IRQn},
 #endif
 #ifdef MR_BSP_PWM_6
         {"pwm6", TIM6, RCC_APB1Periph_TIM6},
@@ -79,21 +94,466 @@ static struct ch32_pwm_data ch32_pwm_data[] =
 
 static struct mr_pwm pwm_device[mr_array_num(ch32_pwm_data)];
 
+static mr_bool_t ch32_pwm_is_advanced(struct ch32_pwm_data *pwm_data)
+{
+    return (pwm_data->Instance == TIM1 || pwm_data->Instance == TIM8
+            || pwm_data->Instance == TIM9 || pwm_data->Instance == TIM10) ? MR_TRUE : MR_FALSE;
+}
+
+static mr_uint32_t ch32_pwm_get_range(struct ch32_pwm_data *pwm_data)
+{
+    /* Center-aligned counts up to the reload and back, edge-aligned wraps after it */
+    if ((pwm_data->Instance->CTLR1 & TIM_CMS) != 0)
+    {
+        return pwm_data->Instance->ATRLR;
+    }
+
+    return pwm_data->Instance->ATRLR + 1;
+}
+
+static mr_uint32_t ch32_pwm_duty_to_compare(struct ch32_pwm_data *pwm_data, mr_uint32_t duty)
+{
+    if (duty > MR_PWM_DUTY_MAX)
+    {
+        duty = MR_PWM_DUTY_MAX;
+    }
+
+    return (mr_uint32_t)(((mr_uint64_t)duty * ch32_pwm_get_range(pwm_data)) / MR_PWM_DUTY_MAX);
+}
+
+static mr_uint16_t ch32_pwm_dead_time_to_dtg(mr_uint32_t ticks)
+{
+    /* Dead-time generator steps: 0-127 x1, 128-254 x2, 256-504 x8, 512-1008 x16, rounded up */
+    if (ticks <= 127)
+    {
+        return (mr_uint16_t)ticks;
+    } else if (ticks <= 254)
+    {
+        return (mr_uint16_t)(0x80 | ((ticks + 1) / 2 - 64));
+    } else if (ticks <= 504)
+    {
+        return (mr_uint16_t)(0xc0 | ((ticks + 7) / 8 - 32));
+    } else if (ticks <= 1008)
+    {
+        return (mr_uint16_t)(0xe0 | ((ticks + 15) / 16 - 32));
+    }
+
+    return 0xffff;
+}
+
+static void ch32_pwm_set_compare(struct ch32_pwm_data *pwm_data, mr_off_t channel, mr_uint32_t compare)
+{
+    switch (channel)
+    {
+        case 1:
+            TIM_SetCompare1(pwm_data->Instance, compare);
+            break;
+        case 2:
+            TIM_SetCompare2(pwm_data->Instance, compare);
+            break;
+        case 3:
+            TIM_SetCompare3(pwm_data->Instance, compare);
+            break;
+        case 4:
+            TIM_SetCompare4(pwm_data->Instance, compare);
+            break;
+
+        default:
+            return;
+    }
+}
+
 static mr_err_t ch32_pwm_configure(mr_pwm_t pwm, mr_pwm_config_t config)
 {
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure = {0};
+    TIM_OCInitTypeDef TIM_OCInitStructure = {0};
+    TIM_BDTRInitTypeDef TIM_BDTRInitStructure = {0};
+    GPIO_InitTypeDef GPIO_InitStructure = {0};
+    RCC_ClocksTypeDef RCC_ClockStructure = {0};
+    mr_uint16_t gpio_pin[4] = {pwm_data->channel1_gpio_pin,
+                               pwm_data->channel2_gpio_pin,
+                               pwm_data->channel3_gpio_pin,
+                               pwm_data->channel4_gpio_pin};
+    mr_uint16_t gpio_n_pin[4] = {pwm_data->channel1n_gpio_pin,
+                                 pwm_data->channel2n_gpio_pin,
+                                 pwm_data->channel3n_gpio_pin,
+                                 0};
+    mr_uint32_t pclk_freq = 0, ticks = 0, prescaler = 0, dtg = 0;
+    mr_off_t channel = 0;
+    mr_bool_t enable = MR_FALSE;
+
+    /* No channel enabled, stop the outputs */
+    if (config->channel._mask == 0)
+    {
+        if (ch32_pwm_is_advanced(pwm_data) == MR_TRUE)
+        {
+            TIM_CtrlPWMOutputs(pwm_data->Instance, DISABLE);
+        }
+        TIM_Cmd(pwm_data->Instance, DISABLE);
+        return MR_ERR_OK;
+    }
+
+    /* Basic timers have no output channel, the others have channels 1-4 */
+    if (pwm_data->Instance == TIM6 || pwm_data->Instance == TIM7)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+    if ((config->channel._mask & ~0x1e) != 0 || config->freq == 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* Complementary outputs, dead time and break input are only on the advanced timers */
+    if ((config->mode == MR_PWM_MODE_COMPLEMENTARY || config->dead_time != 0 || config->brk != MR_PWM_BREAK_NONE)
+        && ch32_pwm_is_advanced(pwm_data) == MR_FALSE)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    /* The trigger point takes the channel 4 compare */
+    if (config->trigger == MR_PWM_TRIGGER_POINT && (config->channel._mask & (1 << 4)) != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    RCC_GetClocksFreq(&RCC_ClockStructure);
 
+    if ((uint32_t)pwm_data->Instance > APB2PERIPH_BASE)
+    {
+        RCC_APB2PeriphClockCmd(pwm_data->tim_periph_clock, ENABLE);
+        if ((RCC->CFGR0 & RCC_PPRE2) == 0)
+        {
+            pclk_freq = RCC_ClockStructure.PCLK2_Frequency;
+        } else
+        {
+            pclk_freq = 2 * RCC_ClockStructure.PCLK2_Frequency;
+        }
+    } else
+    {
+        RCC_APB1PeriphClockCmd(pwm_data->tim_periph_clock, ENABLE);
+        if ((RCC->CFGR0 & RCC_PPRE1) == 0)
+        {
+            pclk_freq = RCC_ClockStructure.PCLK1_Frequency;
+        } else
+        {
+            pclk_freq = 2 * RCC_ClockStructure.PCLK1_Frequency;
+        }
+    }
+
+    /* The dead-time generator runs at the undivided timer clock */
+    dtg = ch32_pwm_dead_time_to_dtg((mr_uint32_t)(((mr_uint64_t)config->dead_time * pclk_freq) / 1000000000));
+    if (dtg == 0xffff)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* A center-aligned period counts up and down */
+    ticks = pclk_freq / config->freq;
+    if (config->align == MR_PWM_ALIGN_CENTER)
+    {
+        ticks /= 2;
+    }
+    if (ticks < 2)
+    {
+        return MR_ERR_INVALID;
+    }
+    prescaler = ticks / 65536 + 1;
+
+    /* The reload is preloaded, a new frequency starts on the period boundary */
+    TIM_TimeBaseInitStructure.TIM_Period = ticks / prescaler - 1;
+    TIM_TimeBaseInitStructure.TIM_Prescaler = prescaler - 1;
+    TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = (config->align == MR_PWM_ALIGN_CENTER) ? TIM_CounterMode_CenterAligned1
+                                                                                      : TIM_CounterMode_Up;
+    TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(pwm_data->Instance, &TIM_TimeBaseInitStructure);
+    TIM_ARRPreloadConfig(pwm_data->Instance, ENABLE);
+
+    if (pwm_data->gpio_port != MR_NULL)
+    {
+        RCC_APB2PeriphClockCmd(pwm_data->gpio_periph_clock, ENABLE);
+    }
+    if (pwm_data->gpio_n_port != MR_NULL)
+    {
+        RCC_APB2PeriphClockCmd(pwm_data->gpio_n_periph_clock, ENABLE);
+    }
+
+    for (channel = 1; channel <= 4; channel++)
+    {
+        enable = (config->channel._mask & (1 << channel)) ? MR_TRUE : MR_FALSE;
+
+        /* The compares are preloaded, the shadow registers take them on the update event */
+        TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
+        TIM_OCInitStructure.TIM_OutputState = (enable == MR_TRUE) ? TIM_OutputState_Enable : TIM_OutputState_Disable;
+        TIM_OCInitStructure.TIM_OutputNState = (enable == MR_TRUE && config->mode == MR_PWM_MODE_COMPLEMENTARY)
+                                               ? TIM_OutputNState_Enable : TIM_OutputNState_Disable;
+        TIM_OCInitStructure.TIM_Pulse = 0;
+        TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+        TIM_OCInitStructure.TIM_OCNPolarity = TIM_OCNPolarity_High;
+        TIM_OCInitStructure.TIM_OCIdleState = TIM_OCIdleState_Reset;
+        TIM_OCInitStructure.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+
+        switch (channel)
+        {
+            case 1:
+                TIM_OC1Init(pwm_data->Instance, &TIM_OCInitStructure);
+                TIM_OC1PreloadConfig(pwm_data->Instance, TIM_OCPreload_Enable);
+                break;
+            case 2:
+                TIM_OC2Init(pwm_data->Instance, &TIM_OCInitStructure);
+                TIM_OC2PreloadConfig(pwm_data->Instance, TIM_OCPreload_Enable);
+                break;
+            case 3:
+                TIM_OC3Init(pwm_data->Instance, &TIM_OCInitStructure);
+                TIM_OC3PreloadConfig(pwm_data->Instance, TIM_OCPreload_Enable);
+                break;
+            case 4:
+                /* Output disabled, the reference goes active once the counter passes the trigger point */
+                if (config->trigger == MR_PWM_TRIGGER_POINT)
+                {
+                    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM2;
+                    TIM_OCInitStructure.TIM_Pulse =
+                        (mr_uint16_t)(((mr_uint64_t)config->trigger_point * (ticks / prescaler - 1)) / MR_PWM_DUTY_MAX);
+                }
+                TIM_OC4Init(pwm_data->Instance, &TIM_OCInitStructure);
+                TIM_OC4PreloadConfig(pwm_data->Instance, TIM_OCPreload_Enable);
+                break;
+        }
+
+        if (enable == MR_TRUE && pwm_data->gpio_port != MR_NULL && gpio_pin[channel - 1] != 0)
+        {
+            GPIO_InitStructure.GPIO_Pin = gpio_pin[channel - 1];
+            GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+            GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+            GPIO_Init(pwm_data->gpio_port, &GPIO_InitStructure);
+        }
+        if (enable == MR_TRUE && config->mode == MR_PWM_MODE_COMPLEMENTARY && pwm_data->gpio_n_port != MR_NULL
+            && gpio_n_pin[channel - 1] != 0)
+        {
+            GPIO_InitStructure.GPIO_Pin = gpio_n_pin[channel - 1];
+            GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+            GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+            GPIO_Init(pwm_data->gpio_n_port, &GPIO_InitStructure);
+        }
+    }
+
+    /* The trigger output (adc external trigger) follows the channel 4 reference */
+    TIM_SelectOutputTrigger(pwm_data->Instance,
+                            (config->trigger == MR_PWM_TRIGGER_POINT) ? TIM_TRGOSource_OC4Ref : TIM_TRGOSource_Reset);
+
+    if (ch32_pwm_is_advanced(pwm_data) == MR_TRUE)
+    {
+        if (config->brk != MR_PWM_BREAK_NONE && pwm_data->gpio_n_port != MR_NULL && pwm_data->break_gpio_pin != 0)
+        {
+            GPIO_InitStructure.GPIO_Pin = pwm_data->break_gpio_pin;
+            GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+            GPIO_Init(pwm_data->gpio_n_port, &GPIO_InitStructure);
+        }
+
+        /* A break forces the idle states, the outputs stay off until the pwm is configured again */
+        TIM_BDTRInitStructure.TIM_OSSRState = TIM_OSSRState_Enable;
+        TIM_BDTRInitStructure.TIM_OSSIState = TIM_OSSIState_Enable;
+        TIM_BDTRInitStructure.TIM_LOCKLevel = TIM_LOCKLevel_OFF;
+        TIM_BDTRInitStructure.TIM_DeadTime = (mr_uint16_t)dtg;
+        TIM_BDTRInitStructure.TIM_Break = (config->brk != MR_PWM_BREAK_NONE) ? TIM_Break_Enable : TIM_Break_Disable;
+        TIM_BDTRInitStructure.TIM_BreakPolarity = (config->brk == MR_PWM_BREAK_HIGH) ? TIM_BreakPolarity_High
+                                                                                     : TIM_BreakPolarity_Low;
+        TIM_BDTRInitStructure.TIM_AutomaticOutput = TIM_AutomaticOutput_Disable;
+        TIM_BDTRConfig(pwm_data->Instance, &TIM_BDTRInitStructure);
+
+        /* Advanced timers gate all outputs with the main output enable */
+        TIM_CtrlPWMOutputs(pwm_data->Instance, ENABLE);
+    }
+    TIM_Cmd(pwm_data->Instance, ENABLE);
+
+    return MR_ERR_OK;
 }
 
 static void ch32_pwm_write(mr_pwm_t pwm, mr_off_t channel, mr_uint32_t duty)
 {
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
 
+    ch32_pwm_set_compare(pwm_data, channel, ch32_pwm_duty_to_compare(pwm_data, duty));
 }
 
 static mr_uint32_t ch32_pwm_read(mr_pwm_t pwm, mr_off_t channel)
 {
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+    mr_uint32_t compare = 0;
+
+    switch (channel)
+    {
+        case 1:
+            compare = TIM_GetCapture1(pwm_data->Instance);
+            break;
+        case 2:
+            compare = TIM_GetCapture2(pwm_data->Instance);
+            break;
+        case 3:
+            compare = TIM_GetCapture3(pwm_data->Instance);
+            break;
+        case 4:
+            compare = TIM_GetCapture4(pwm_data->Instance);
+            break;
+
+        default:
+            return 0;
+    }
 
+    return (mr_uint32_t)(((mr_uint64_t)compare * MR_PWM_DUTY_MAX) / ch32_pwm_get_range(pwm_data));
 }
 
+static volatile mr_uint16_t *ch32_pwm_get_compare_address(struct ch32_pwm_data *pwm_data, mr_off_t channel)
+{
+    switch (channel)
+    {
+        case 1:
+            return (volatile mr_uint16_t *)&pwm_data->Instance->CH1CVR;
+        case 2:
+            return (volatile mr_uint16_t *)&pwm_data->Instance->CH2CVR;
+        case 3:
+            return (volatile mr_uint16_t *)&pwm_data->Instance->CH3CVR;
+        case 4:
+            return (volatile mr_uint16_t *)&pwm_data->Instance->CH4CVR;
+
+        default:
+            return MR_NULL;
+    }
+}
+
+static void ch32_pwm_write_multi(mr_pwm_t pwm, mr_uint32_t mask, const mr_uint32_t *duty)
+{
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+    mr_off_t channel = 0;
+
+    /* Hold the update event, so no period boundary can split the compares */
+    TIM_UpdateDisableConfig(pwm_data->Instance, ENABLE);
+
+    for (channel = 1; channel <= 4; channel++)
+    {
+        if (mask & (1 << channel))
+        {
+            ch32_pwm_set_compare(pwm_data, channel, ch32_pwm_duty_to_compare(pwm_data, *duty));
+            duty++;
+        }
+    }
+
+    TIM_UpdateDisableConfig(pwm_data->Instance, DISABLE);
+}
+
+static mr_err_t ch32_pwm_start_burst(mr_pwm_t pwm, mr_pwm_burst_t burst)
+{
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+    DMA_InitTypeDef DMA_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+    volatile mr_uint16_t *compare = ch32_pwm_get_compare_address(pwm_data, burst->channel);
+
+    /* Only the timers with a free update dma request support the burst */
+    if (pwm_data->dma_channel == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    if (compare == MR_NULL || burst->count > MR_UINT16_MAX)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* The line stays low until the first compare is latched */
+    ch32_pwm_set_compare(pwm_data, burst->channel, 0);
+
+    /* Every update event moves the next compare into the preload register */
+    RCC_AHBPeriphClockCmd(pwm_data->dma_periph_clock, ENABLE);
+    DMA_DeInit(pwm_data->dma_channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)compare;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)burst->buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = burst->count;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(pwm_data->dma_channel, &DMA_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = pwm_data->dma_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    DMA_ITConfig(pwm_data->dma_channel, DMA_IT_TC, ENABLE);
+    DMA_Cmd(pwm_data->dma_channel, ENABLE);
+
+    TIM_DMACmd(pwm_data->Instance, TIM_DMA_Update, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static void ch32_pwm_stop_burst(mr_pwm_t pwm)
+{
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+
+    if (pwm_data->dma_channel == MR_NULL)
+    {
+        return;
+    }
+
+    TIM_DMACmd(pwm_data->Instance, TIM_DMA_Update, DISABLE);
+    DMA_Cmd(pwm_data->dma_channel, DISABLE);
+    DMA_ITConfig(pwm_data->dma_channel, DMA_IT_TC, DISABLE);
+
+    /*
+     * Leave the line low. When the burst is done the dma has just moved the terminating 0 into the preload,
+     * the last data compare is still running until the next update event, on abort the line goes low there.
+     */
+    ch32_pwm_set_compare(pwm_data, pwm->burst.channel, 0);
+}
+
+static mr_uint32_t ch32_pwm_get_period(mr_pwm_t pwm)
+{
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+
+    return ch32_pwm_get_range(pwm_data);
+}
+
+static void ch32_pwm_dma_isr(mr_pwm_t pwm)
+{
+    struct ch32_pwm_data *pwm_data = (struct ch32_pwm_data *)pwm->device.data;
+
+    if (DMA_GetITStatus(pwm_data->dma_it_tc) != RESET)
+    {
+        mr_pwm_device_isr(pwm, MR_PWM_EVENT_BURST_DONE);
+        DMA_ClearITPendingBit(pwm_data->dma_it_tc);
+    }
+}
+
+#if defined(MR_BSP_PWM_2) && !defined(MR_BSP_SPI_1)
+void DMA1_Channel2_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel2_IRQHandler(void)
+{
+    ch32_pwm_dma_isr(&pwm_device[CH32_PWM_2_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_PWM_4
+void DMA1_Channel7_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel7_IRQHandler(void)
+{
+    ch32_pwm_dma_isr(&pwm_device[CH32_PWM_4_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_PWM_5
+void DMA2_Channel2_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA2_Channel2_IRQHandler(void)
+{
+    ch32_pwm_dma_isr(&pwm_device[CH32_PWM_5_INDEX]);
+}
+#endif
+
 mr_err_t drv_pwm_init(void)
 {
     static struct mr_pwm_ops drv_ops =
@@ -101,6 +561,10 @@ mr_err_t drv_pwm_init(void)
             ch32_pwm_configure,
             ch32_pwm_write,
             ch32_pwm_read,
+            ch32_pwm_write_multi,
+            ch32_pwm_start_burst,
+            ch32_pwm_stop_burst,
+            ch32_pwm_get_period,
         };
     mr_size_t count = mr_array_num(pwm_device);
     mr_err_t ret = MR_ERR_OK;
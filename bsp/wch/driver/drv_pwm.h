@@ -28,6 +28,17 @@ struct ch32_pwm_data
     mr_uint16_t channel2_gpio_pin;
     mr_uint16_t channel3_gpio_pin;
     mr_uint16_t channel4_gpio_pin;
+    mr_uint32_t gpio_n_periph_clock;
+    GPIO_TypeDef *gpio_n_port;
+    mr_uint16_t channel1n_gpio_pin;
+    mr_uint16_t channel2n_gpio_pin;
+    mr_uint16_t channel3n_gpio_pin;
+    mr_uint16_t break_gpio_pin;
+
+    mr_uint32_t dma_periph_clock;
+    DMA_Channel_TypeDef *dma_channel;
+    mr_uint32_t dma_it_tc;
+    IRQn_Type dma_irqno;
 };
 
 #endif
@@ -32,14 +32,16 @@ enum drv_spi_index
 static struct drv_spi_bus_data drv_spi_bus_data[] =
     {
 #ifdef MR_BSP_SPI_1
-        {"spi1", SPI1, RCC_APB2Periph_SPI1, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_5, GPIO_Pin_6, GPIO_Pin_7, SPI1_IRQn},
+        {"spi1", SPI1, RCC_APB2Periph_SPI1, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_5, GPIO_Pin_6, GPIO_Pin_7, SPI1_IRQn,
+         RCC_AHBPeriph_DMA1, DMA1_Channel2, DMA1_IT_HT2, DMA1_IT_TC2, DMA1_Channel2_IRQn},
 #endif
 #ifdef MR_BSP_SPI_2
         {"spi2", SPI2, RCC_APB1Periph_SPI2, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_13, GPIO_Pin_14, GPIO_Pin_15,
-         SPI2_IRQn},
+         SPI2_IRQn, RCC_AHBPeriph_DMA1, DMA1_Channel4, DMA1_IT_HT4, DMA1_IT_TC4, DMA1_Channel4_IRQn},
 #endif
 #ifdef MR_BSP_SPI_3
-        {"spi3", SPI3, RCC_APB1Periph_SPI3, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_3, GPIO_Pin_4, GPIO_Pin_5, SPI3_IRQn},
+        {"spi3", SPI3, RCC_APB1Periph_SPI3, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_3, GPIO_Pin_4, GPIO_Pin_5, SPI3_IRQn,
+         RCC_AHBPeriph_DMA2, DMA2_Channel1, DMA2_IT_HT1, DMA2_IT_TC1, DMA2_Channel1_IRQn},
 #endif
     };
 
@@ -291,7 +293,7 @@ static mr_uint32_t drv_spi_read(mr_spi_bus_t spi_bus)
 
 static void drv_spi_cs_write(mr_spi_bus_t spi_bus, mr_off_t cs_number, mr_level_t level)
 {
-    if (cs_number > MR_BSP_PIN_NUMBER)
+    if (cs_number >= MR_BSP_PIN_NUMBER)
     {
         return;
     }
@@ -301,12 +303,102 @@ static void drv_spi_cs_write(mr_spi_bus_t spi_bus, mr_off_t cs_number, mr_level_
 
 static mr_level_t drv_spi_cs_read(mr_spi_bus_t spi_bus, mr_off_t cs_number)
 {
-    if (cs_number > MR_BSP_PIN_NUMBER)
+    if (cs_number >= MR_BSP_PIN_NUMBER)
     {
         return 0;
     }
 
-    return (mr_level_t)GPIO_ReadOutputDataBit(PIN_STPORT(cs_number), PIN_STPIN(cs_number));
+    /* The input level is read, the chip-select of the slave is driven by the host */
+    return (mr_level_t)GPIO_ReadInputDataBit(PIN_STPORT(cs_number), PIN_STPIN(cs_number));
+}
+
+static mr_err_t drv_spi_start_rx_dma(mr_spi_bus_t spi_bus, void *buffer, mr_size_t size)
+{
+    struct drv_spi_bus_data *spi_bus_data = (struct drv_spi_bus_data *)spi_bus->device.data;
+    DMA_InitTypeDef DMA_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+    mr_size_t data_size = (spi_bus->config.data_bits >> 3);
+
+    if (size < (data_size * 2) || size % data_size != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    RCC_AHBPeriphClockCmd(spi_bus_data->dma_periph_clock, ENABLE);
+
+    DMA_DeInit(spi_bus_data->rx_dma_channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&spi_bus_data->instance->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = size / data_size;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    if (data_size == 1)
+    {
+        DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+        DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    } else
+    {
+        DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+        DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    }
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(spi_bus_data->rx_dma_channel, &DMA_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = spi_bus_data->rx_dma_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    DMA_ITConfig(spi_bus_data->rx_dma_channel, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+    /* Receive by dma instead of the per-word interrupt */
+    SPI_I2S_ITConfig(spi_bus_data->instance, SPI_I2S_IT_RXNE, DISABLE);
+    SPI_I2S_DMACmd(spi_bus_data->instance, SPI_I2S_DMAReq_Rx, ENABLE);
+    DMA_Cmd(spi_bus_data->rx_dma_channel, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static void drv_spi_stop_rx_dma(mr_spi_bus_t spi_bus)
+{
+    struct drv_spi_bus_data *spi_bus_data = (struct drv_spi_bus_data *)spi_bus->device.data;
+
+    DMA_Cmd(spi_bus_data->rx_dma_channel, DISABLE);
+    DMA_ITConfig(spi_bus_data->rx_dma_channel, DMA_IT_HT | DMA_IT_TC, DISABLE);
+    SPI_I2S_DMACmd(spi_bus_data->instance, SPI_I2S_DMAReq_Rx, DISABLE);
+
+    /* The slave falls back to the per-word interrupt */
+    if (spi_bus->config.host_slave == MR_SPI_SLAVE)
+    {
+        SPI_I2S_ITConfig(spi_bus_data->instance, SPI_I2S_IT_RXNE, ENABLE);
+    }
+}
+
+static mr_size_t drv_spi_get_rx_dma_count(mr_spi_bus_t spi_bus)
+{
+    struct drv_spi_bus_data *spi_bus_data = (struct drv_spi_bus_data *)spi_bus->device.data;
+
+    return DMA_GetCurrDataCounter(spi_bus_data->rx_dma_channel) * (spi_bus->config.data_bits >> 3);
+}
+
+static void drv_spi_rx_dma_isr(mr_spi_bus_t spi_bus)
+{
+    struct drv_spi_bus_data *spi_bus_data = (struct drv_spi_bus_data *)spi_bus->device.data;
+
+    if (DMA_GetITStatus(spi_bus_data->rx_dma_it_ht) != RESET)
+    {
+        mr_spi_bus_isr(spi_bus, MR_SPI_BUS_EVENT_RX_DMA);
+        DMA_ClearITPendingBit(spi_bus_data->rx_dma_it_ht);
+    }
+
+    if (DMA_GetITStatus(spi_bus_data->rx_dma_it_tc) != RESET)
+    {
+        mr_spi_bus_isr(spi_bus, MR_SPI_BUS_EVENT_RX_DMA);
+        DMA_ClearITPendingBit(spi_bus_data->rx_dma_it_tc);
+    }
 }
 
 static void drv_spi_isr(mr_spi_bus_t spi_bus)
@@ -344,6 +436,30 @@ void SPI3_IRQHandler(void)
 }
 #endif
 
+#ifdef MR_BSP_SPI_1
+void DMA1_Channel2_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel2_IRQHandler(void)
+{
+    drv_spi_rx_dma_isr(&spi_bus_device[DRV_SPI_1_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_SPI_2
+void DMA1_Channel4_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel4_IRQHandler(void)
+{
+    drv_spi_rx_dma_isr(&spi_bus_device[DRV_SPI_2_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_SPI_3
+void DMA2_Channel1_IRQHandler(void)  __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA2_Channel1_IRQHandler(void)
+{
+    drv_spi_rx_dma_isr(&spi_bus_device[DRV_SPI_3_INDEX]);
+}
+#endif
+
 mr_err_t drv_spi_bus_init(void)
 {
     static struct mr_spi_bus_ops drv_ops =
@@ -353,6 +469,9 @@ mr_err_t drv_spi_bus_init(void)
             drv_spi_read,
             drv_spi_cs_write,
             drv_spi_cs_read,
+            drv_spi_start_rx_dma,
+            drv_spi_stop_rx_dma,
+            drv_spi_get_rx_dma_count,
         };
     mr_size_t count = mr_array_num(spi_bus_device);
     mr_err_t ret = MR_ERR_OK;
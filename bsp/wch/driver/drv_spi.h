@@ -31,6 +31,12 @@ struct drv_spi_bus_data
     mr_uint16_t miso_gpio_pin;
     mr_uint16_t mosi_gpio_pin;
     IRQn_Type irqno;
+
+    mr_uint32_t dma_periph_clock;
+    DMA_Channel_TypeDef *rx_dma_channel;
+    mr_uint32_t rx_dma_it_ht;
+    mr_uint32_t rx_dma_it_tc;
+    IRQn_Type rx_dma_irqno;
 };
 
 #endif
@@ -49,34 +49,34 @@ enum
 static struct drv_timer_data drv_timer_data[] =
     {
 #ifdef MR_BSP_TIMER_1
-        {"timer1", TIM1, RCC_APB2Periph_TIM1, TIM1_UP_IRQn},
+        {"timer1", TIM1, RCC_APB2Periph_TIM1, TIM1_UP_IRQn, TIM1_CC_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_2
-        {"timer2", TIM2, RCC_APB1Periph_TIM2, TIM2_IRQn},
+        {"timer2", TIM2, RCC_APB1Periph_TIM2, TIM2_IRQn, TIM2_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_3
-        {"timer3", TIM3, RCC_APB1Periph_TIM3, TIM3_IRQn},
+        {"timer3", TIM3, RCC_APB1Periph_TIM3, TIM3_IRQn, TIM3_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_4
-        {"timer4", TIM4, RCC_APB1Periph_TIM4, TIM4_IRQn},
+        {"timer4", TIM4, RCC_APB1Periph_TIM4, TIM4_IRQn, TIM4_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_5
-        {"timer5", TIM5, RCC_APB1Periph_TIM5, TIM5_IRQn},
+        {"timer5", TIM5, RCC_APB1Periph_TIM5, TIM5_IRQn, TIM5_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_6
-        {"timer6", TIM6, RCC_APB1Periph_TIM6, TIM6_IRQn},
+        {"timer6", TIM6, RCC_APB1Periph_TIM6, TIM6_IRQn, TIM6_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_7
-        {"timer7", TIM7, RCC_APB1Periph_TIM7, TIM7_IRQn},
+        {"timer7", TIM7, RCC_APB1Periph_TIM7, TIM7_IRQn, TIM7_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_8
-        {"timer8", TIM8, RCC_APB2Periph_TIM8, TIM8_UP_IRQn},
+        {"timer8", TIM8, RCC_APB2Periph_TIM8, TIM8_UP_IRQn, TIM8_CC_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_9
-        {"timer9", TIM9, RCC_APB2Periph_TIM9, TIM9_UP_IRQn},
+        {"timer9", TIM9, RCC_APB2Periph_TIM9, TIM9_UP_IRQn, TIM9_CC_IRQn},
 #endif
 #ifdef MR_BSP_TIMER_10
-        {"timer10", TIM10, RCC_APB2Periph_TIM10, TIM10_UP_IRQn},
+        {"timer10", TIM10, RCC_APB2Periph_TIM10, TIM10_UP_IRQn, TIM10_CC_IRQn},
 #endif
     };
 
@@ -84,6 +84,10 @@ static struct mr_timer_data timer_device_data = {144000000, 0xffff, 0xffff, MR_T
 
 static struct mr_timer timer_device[mr_array_num(drv_timer_data)];
 
+static const mr_uint16_t drv_timer_channel[] = {TIM_Channel_1, TIM_Channel_2, TIM_Channel_3, TIM_Channel_4};
+
+static const mr_uint16_t drv_timer_it_cc[] = {TIM_IT_CC1, TIM_IT_CC2, TIM_IT_CC3, TIM_IT_CC4};
+
 static mr_err_t drv_timer_configure(mr_timer_t timer, mr_state_t state)
 {
     struct drv_timer_data *timer_data = (struct drv_timer_data *)timer->device.data;
@@ -196,15 +200,144 @@ static mr_uint32_t drv_timer_get_count(mr_timer_t timer)
     return timer_data->instance->CNT;
 }
 
+static mr_err_t drv_timer_capture(mr_timer_t timer, mr_uint32_t channel, mr_uint32_t edge)
+{
+    struct drv_timer_data *timer_data = (struct drv_timer_data *)timer->device.data;
+    TIM_ICInitTypeDef TIM_ICInitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+
+    /* Basic timers have no capture channel */
+    if (timer_data->instance == TIM6 || timer_data->instance == TIM7)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    if (channel < 1 || channel > 4)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    switch (edge)
+    {
+        case MR_TIMER_CAPTURE_NONE:
+        {
+            TIM_ITConfig(timer_data->instance, drv_timer_it_cc[channel - 1], DISABLE);
+            TIM_CCxCmd(timer_data->instance, drv_timer_channel[channel - 1], TIM_CCx_Disable);
+            return MR_ERR_OK;
+        }
+
+        case MR_TIMER_CAPTURE_RISING:
+        case MR_TIMER_CAPTURE_BOTH:
+        {
+            TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;
+            break;
+        }
+
+        case MR_TIMER_CAPTURE_FALLING:
+        {
+            TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Falling;
+            break;
+        }
+
+        default:
+            return MR_ERR_INVALID;
+    }
+
+    TIM_ICInitStructure.TIM_Channel = drv_timer_channel[channel - 1];
+    TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStructure.TIM_ICFilter = 0;
+    TIM_ICInit(timer_data->instance, &TIM_ICInitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = timer_data->cc_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    TIM_ClearITPendingBit(timer_data->instance, drv_timer_it_cc[channel - 1]);
+    TIM_ITConfig(timer_data->instance, drv_timer_it_cc[channel - 1], ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static mr_uint32_t drv_timer_get_capture(mr_timer_t timer, mr_uint32_t channel)
+{
+    struct drv_timer_data *timer_data = (struct drv_timer_data *)timer->device.data;
+
+    switch (channel)
+    {
+        case 1:
+            return TIM_GetCapture1(timer_data->instance);
+
+        case 2:
+            return TIM_GetCapture2(timer_data->instance);
+
+        case 3:
+            return TIM_GetCapture3(timer_data->instance);
+
+        case 4:
+            return TIM_GetCapture4(timer_data->instance);
+
+        default:
+            return 0;
+    }
+}
+
+static mr_bool_t drv_timer_get_pending(mr_timer_t timer)
+{
+    struct drv_timer_data *timer_data = (struct drv_timer_data *)timer->device.data;
+
+    return TIM_GetFlagStatus(timer_data->instance, TIM_FLAG_Update) != RESET;
+}
+
+static void drv_timer_capture_isr(mr_timer_t timer, mr_bool_t before_update)
+{
+    struct drv_timer_data *timer_data = (struct drv_timer_data *)timer->device.data;
+    mr_uint32_t channel = 0, count = 0;
+
+    for (channel = 1; channel <= 4; channel++)
+    {
+        if (TIM_GetITStatus(timer_data->instance, drv_timer_it_cc[channel - 1]) == RESET)
+        {
+            continue;
+        }
+
+        /* A count latched in the second half of the period was taken before the pending update */
+        count = drv_timer_get_capture(timer, channel);
+        if (timer->data->count_mode == MR_TIMER_COUNT_MODE_DOWN)
+        {
+            count = timer_data->instance->ATRLR - count;
+        }
+        if (before_update == MR_TRUE && count < timer_data->instance->ATRLR / 2)
+        {
+            continue;
+        }
+
+        /* The hardware captures one edge, both edges alternate the polarity */
+        if (timer->config.capture == MR_TIMER_CAPTURE_BOTH)
+        {
+            timer_data->instance->CCER ^= (TIM_CC1P << ((channel - 1) * 4));
+        }
+
+        mr_timer_device_isr(timer, MR_TIMER_EVENT_CAPTURE_INT | channel);
+        TIM_ClearITPendingBit(timer_data->instance, drv_timer_it_cc[channel - 1]);
+    }
+}
+
 static void drv_timer_isr(mr_timer_t timer)
 {
     struct drv_timer_data *timer_data = (struct drv_timer_data *)timer->device.data;
 
     if (TIM_GetITStatus(timer_data->instance, TIM_IT_Update) != RESET)
     {
-        mr_timer_device_isr(timer, MR_TIMER_EVENT_PIT_INT);
+        drv_timer_capture_isr(timer, MR_TRUE);
+
+        /* Clear the update right before counting it, only a read preempting both steps misses the wrap */
         TIM_ClearITPendingBit(timer_data->instance, TIM_IT_Update);
+        mr_timer_device_isr(timer, MR_TIMER_EVENT_PIT_INT);
     }
+
+    drv_timer_capture_isr(timer, MR_FALSE);
 }
 
 #ifdef MR_BSP_TIMER_1
@@ -215,6 +348,14 @@ void TIM1_UP_IRQHandler(void)
 }
 #endif
 
+#ifdef MR_BSP_TIMER_1
+void TIM1_CC_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void TIM1_CC_IRQHandler(void)
+{
+    drv_timer_isr(&timer_device[DRV_TIMER_1_INDEX]);
+}
+#endif
+
 #ifdef MR_BSP_TIMER_2
 void TIM2_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 void TIM2_IRQHandler(void)
@@ -271,6 +412,14 @@ void TIM8_UP_IRQHandler(void)
 }
 #endif
 
+#ifdef MR_BSP_TIMER_8
+void TIM8_CC_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void TIM8_CC_IRQHandler(void)
+{
+    drv_timer_isr(&timer_device[DRV_TIMER_8_INDEX]);
+}
+#endif
+
 #ifdef MR_BSP_TIMER_9
 void TIM9_UP_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 void TIM9_UP_IRQHandler(void)
@@ -279,6 +428,14 @@ void TIM9_UP_IRQHandler(void)
 }
 #endif
 
+#ifdef MR_BSP_TIMER_9
+void TIM9_CC_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void TIM9_CC_IRQHandler(void)
+{
+    drv_timer_isr(&timer_device[DRV_TIMER_9_INDEX]);
+}
+#endif
+
 #ifdef MR_BSP_TIMER_10
 void TIM10_UP_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
 void TIM10_UP_IRQHandler(void)
@@ -287,6 +444,14 @@ void TIM10_UP_IRQHandler(void)
 }
 #endif
 
+#ifdef MR_BSP_TIMER_10
+void TIM10_CC_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void TIM10_CC_IRQHandler(void)
+{
+    drv_timer_isr(&timer_device[DRV_TIMER_10_INDEX]);
+}
+#endif
+
 mr_err_t drv_timer_init(void)
 {
     static struct mr_timer_ops drv_ops =
@@ -295,6 +460,9 @@ mr_err_t drv_timer_init(void)
             drv_timer_start,
             drv_timer_stop,
             drv_timer_get_count,
+            drv_timer_capture,
+            drv_timer_get_capture,
+            drv_timer_get_pending,
         };
     mr_size_t count = mr_array_num(timer_device);
     mr_err_t ret = MR_ERR_OK;
@@ -26,6 +26,7 @@ struct drv_timer_data
     TIM_TypeDef *instance;
     mr_uint32_t timer_periph_clock;
     IRQn_Type irqno;
+    IRQn_Type cc_irqno;
 };
 
 #endif
@@ -44,19 +44,20 @@ static struct drv_uart_data drv_uart_data[] =
     {
 #ifdef MR_BSP_UART_1
         {"uart1", USART1, RCC_APB2Periph_USART1, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_9, GPIOA, GPIO_Pin_10,
-         USART1_IRQn},
+         USART1_IRQn, RCC_AHBPeriph_DMA1, DMA1_Channel5, DMA1_IT_HT5, DMA1_IT_TC5, DMA1_Channel5_IRQn},
 #endif
 #ifdef MR_BSP_UART_2
         {"uart2", USART2, RCC_APB1Periph_USART2, RCC_APB2Periph_GPIOA, GPIOA, GPIO_Pin_2, GPIOA, GPIO_Pin_3,
-         USART2_IRQn},
+         USART2_IRQn, RCC_AHBPeriph_DMA1, DMA1_Channel6, DMA1_IT_HT6, DMA1_IT_TC6, DMA1_Channel6_IRQn},
 #endif
 #ifdef MR_BSP_UART_3
         {"uart3", USART3, RCC_APB1Periph_USART2, RCC_APB2Periph_GPIOB, GPIOB, GPIO_Pin_10, GPIOB, GPIO_Pin_11,
-         USART3_IRQn},
+         USART3_IRQn, RCC_AHBPeriph_DMA1, DMA1_Channel3, DMA1_IT_HT3, DMA1_IT_TC3, DMA1_Channel3_IRQn},
 #endif
 #ifdef MR_BSP_UART_4
         {"uart4", UART4, RCC_APB1Periph_UART4, RCC_APB2Periph_GPIOC, GPIOC, GPIO_Pin_10, GPIOC, GPIO_Pin_11,
-         UART4_IRQn},
+         UART4_IRQn, RCC_AHBPeriph_DMA2, DMA2_Channel3, DMA2_IT_HT3, DMA2_IT_TC3, DMA2_Channel3_IRQn,
+         DMA2_Channel5, DMA2_IT_TC5, DMA2_Channel5_IRQn},
 #endif
 #ifdef MR_BSP_UART_5
         {"uart5", UART5, RCC_APB1Periph_UART5, RCC_APB2Periph_GPIOC | RCC_APB2Periph_GPIOD, GPIOC, GPIO_Pin_12, GPIOD,
@@ -202,6 +203,12 @@ static mr_err_t drv_serial_configure(mr_serial_t serial, struct mr_serial_config
     NVIC_Init(&NVIC_InitStructure);
     USART_ITConfig(uart_data->instance, USART_IT_RXNE, ENABLE);
 
+    /* The receive timeout may be set before the clock is enabled */
+    if (serial->rx_timeout != 0)
+    {
+        USART_ITConfig(uart_data->instance, USART_IT_IDLE, ENABLE);
+    }
+
     USART_InitStructure.USART_BaudRate = config->baud_rate;
     USART_InitStructure.USART_HardwareFlowControl = 0;
     USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
@@ -257,6 +264,177 @@ static void drv_serial_stop_tx(mr_serial_t serial)
     USART_ITConfig(uart_data->instance, USART_IT_TXE, DISABLE);
 }
 
+static mr_err_t drv_serial_start_rx_dma(mr_serial_t serial, void *buffer, mr_size_t size)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+    DMA_InitTypeDef DMA_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+
+    /* Uart5-8 have no dma channel assigned */
+    if (uart_data->rx_dma_channel == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    if (size < 2)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    RCC_AHBPeriphClockCmd(uart_data->dma_periph_clock, ENABLE);
+
+    DMA_DeInit(uart_data->rx_dma_channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&uart_data->instance->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = size;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(uart_data->rx_dma_channel, &DMA_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = uart_data->rx_dma_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    DMA_ITConfig(uart_data->rx_dma_channel, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+    /* Receive by dma instead of the per-byte interrupt, the idle line ends a burst */
+    USART_ITConfig(uart_data->instance, USART_IT_RXNE, DISABLE);
+    USART_ITConfig(uart_data->instance, USART_IT_IDLE, ENABLE);
+    USART_DMACmd(uart_data->instance, USART_DMAReq_Rx, ENABLE);
+    DMA_Cmd(uart_data->rx_dma_channel, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static void drv_serial_stop_rx_dma(mr_serial_t serial)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    if (uart_data->rx_dma_channel == MR_NULL)
+    {
+        return;
+    }
+
+    DMA_Cmd(uart_data->rx_dma_channel, DISABLE);
+    DMA_ITConfig(uart_data->rx_dma_channel, DMA_IT_HT | DMA_IT_TC, DISABLE);
+    USART_DMACmd(uart_data->instance, USART_DMAReq_Rx, DISABLE);
+    USART_ITConfig(uart_data->instance, USART_IT_RXNE, ENABLE);
+
+    /* The idle line is still needed by the receive timeout */
+    if (serial->rx_timeout == 0)
+    {
+        USART_ITConfig(uart_data->instance, USART_IT_IDLE, DISABLE);
+    }
+}
+
+static mr_size_t drv_serial_get_rx_dma_count(mr_serial_t serial)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    return DMA_GetCurrDataCounter(uart_data->rx_dma_channel);
+}
+
+static mr_err_t drv_serial_start_tx_dma(mr_serial_t serial, const void *buffer, mr_size_t size)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+    DMA_InitTypeDef DMA_InitStructure = {0};
+    NVIC_InitTypeDef NVIC_InitStructure = {0};
+
+    RCC_AHBPeriphClockCmd(uart_data->dma_periph_clock, ENABLE);
+
+    DMA_DeInit(uart_data->tx_dma_channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&uart_data->instance->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = size;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(uart_data->tx_dma_channel, &DMA_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = uart_data->tx_dma_irqno;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    DMA_ITConfig(uart_data->tx_dma_channel, DMA_IT_TC, ENABLE);
+
+    USART_DMACmd(uart_data->instance, USART_DMAReq_Tx, ENABLE);
+    DMA_Cmd(uart_data->tx_dma_channel, ENABLE);
+
+    return MR_ERR_OK;
+}
+
+static void drv_serial_stop_tx_dma(mr_serial_t serial)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    DMA_Cmd(uart_data->tx_dma_channel, DISABLE);
+    DMA_ITConfig(uart_data->tx_dma_channel, DMA_IT_TC, DISABLE);
+    USART_DMACmd(uart_data->instance, USART_DMAReq_Tx, DISABLE);
+}
+
+static mr_err_t drv_serial_set_rx_timeout(mr_serial_t serial, mr_uint32_t timeout)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    /* The usart has no receive timeout counter, only the idle line (one frame) can be timed */
+    if (timeout > MR_SERIAL_FRAME_BITS(&serial->config))
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    if (timeout != 0)
+    {
+        USART_ITConfig(uart_data->instance, USART_IT_IDLE, ENABLE);
+    } else if (serial->rx_dma != MR_ENABLE)
+    {
+        USART_ITConfig(uart_data->instance, USART_IT_IDLE, DISABLE);
+    }
+
+    return MR_ERR_OK;
+}
+
+static void drv_serial_rx_dma_isr(mr_serial_t serial)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    if (DMA_GetITStatus(uart_data->rx_dma_it_ht) != RESET)
+    {
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_RX_DMA);
+        DMA_ClearITPendingBit(uart_data->rx_dma_it_ht);
+    }
+
+    if (DMA_GetITStatus(uart_data->rx_dma_it_tc) != RESET)
+    {
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_RX_DMA);
+        DMA_ClearITPendingBit(uart_data->rx_dma_it_tc);
+    }
+}
+
+static void drv_serial_tx_dma_isr(mr_serial_t serial)
+{
+    struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
+
+    /* Cleared first, the next block may be started from the event */
+    if (DMA_GetITStatus(uart_data->tx_dma_it_tc) != RESET)
+    {
+        DMA_ClearITPendingBit(uart_data->tx_dma_it_tc);
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_TX_DMA);
+    }
+}
+
 static void drv_serial_isr(mr_serial_t serial)
 {
     struct drv_uart_data *uart_data = (struct drv_uart_data *)serial->device.data;
@@ -267,6 +445,13 @@ static void drv_serial_isr(mr_serial_t serial)
         USART_ClearITPendingBit(uart_data->instance, USART_IT_RXNE);
     }
 
+    /* The received data is taken first, clearing the idle flag reads the data register */
+    if (USART_GetITStatus(uart_data->instance, USART_IT_IDLE) != RESET)
+    {
+        USART_ReceiveData(uart_data->instance);
+        mr_serial_device_isr(serial, MR_SERIAL_EVENT_RX_IDLE);
+    }
+
     if (USART_GetITStatus(uart_data->instance, USART_IT_TXE) != RESET)
     {
         mr_serial_device_isr(serial, MR_SERIAL_EVENT_TX_INT);
@@ -338,6 +523,46 @@ void UART8_IRQHandler(void)
 }
 #endif
 
+#ifdef MR_BSP_UART_1
+void DMA1_Channel5_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel5_IRQHandler(void)
+{
+    drv_serial_rx_dma_isr(&serial_device[DRV_UART_1_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_UART_2
+void DMA1_Channel6_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel6_IRQHandler(void)
+{
+    drv_serial_rx_dma_isr(&serial_device[DRV_UART_2_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_UART_3
+void DMA1_Channel3_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA1_Channel3_IRQHandler(void)
+{
+    drv_serial_rx_dma_isr(&serial_device[DRV_UART_3_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_UART_4
+void DMA2_Channel3_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA2_Channel3_IRQHandler(void)
+{
+    drv_serial_rx_dma_isr(&serial_device[DRV_UART_4_INDEX]);
+}
+#endif
+
+#ifdef MR_BSP_UART_4
+void DMA2_Channel5_IRQHandler(void) __attribute__((interrupt("WCH-Interrupt-fast")));
+void DMA2_Channel5_IRQHandler(void)
+{
+    drv_serial_tx_dma_isr(&serial_device[DRV_UART_4_INDEX]);
+}
+#endif
+
 mr_err_t drv_uart_init(void)
 {
     static struct mr_serial_ops drv_ops =
@@ -347,13 +572,41 @@ mr_err_t drv_uart_init(void)
             drv_serial_read,
             drv_serial_start_tx,
             drv_serial_stop_tx,
+            drv_serial_start_rx_dma,
+            drv_serial_stop_rx_dma,
+            drv_serial_get_rx_dma_count,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            MR_NULL,
+            drv_serial_set_rx_timeout,
+        };
+    static struct mr_serial_ops drv_tx_dma_ops =
+        {
+            drv_serial_configure,
+            drv_serial_write,
+            drv_serial_read,
+            drv_serial_start_tx,
+            drv_serial_stop_tx,
+            drv_serial_start_rx_dma,
+            drv_serial_stop_rx_dma,
+            drv_serial_get_rx_dma_count,
+            MR_NULL,
+            MR_NULL,
+            drv_serial_start_tx_dma,
+            drv_serial_stop_tx_dma,
+            drv_serial_set_rx_timeout,
         };
     mr_size_t count = mr_array_num(serial_device);
     mr_err_t ret = MR_ERR_OK;
 
     while (count--)
     {
-        ret = mr_serial_device_add(&serial_device[count], drv_uart_data[count].name, &drv_ops, &drv_uart_data[count]);
+        /* The tx dma channels of uart1-3 are taken by spi and pwm, only uart4 sends by dma */
+        ret = mr_serial_device_add(&serial_device[count],
+                                   drv_uart_data[count].name,
+                                   (drv_uart_data[count].tx_dma_channel != MR_NULL) ? &drv_tx_dma_ops : &drv_ops,
+                                   &drv_uart_data[count]);
         MR_ASSERT(ret == MR_ERR_OK);
     }
 
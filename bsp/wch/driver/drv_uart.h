@@ -31,6 +31,15 @@ struct drv_uart_data
     GPIO_TypeDef *rx_gpio_port;
     mr_uint16_t rx_gpio_pin;
     IRQn_Type irqno;
+
+    mr_uint32_t dma_periph_clock;
+    DMA_Channel_TypeDef *rx_dma_channel;
+    mr_uint32_t rx_dma_it_ht;
+    mr_uint32_t rx_dma_it_tc;
+    IRQn_Type rx_dma_irqno;
+    DMA_Channel_TypeDef *tx_dma_channel;
+    mr_uint32_t tx_dma_it_tc;
+    IRQn_Type tx_dma_irqno;
 };
 
 #endif
@@ -10,6 +10,58 @@
 
 #include "mrboard.h"
 
+void mr_delay_ns(mr_uint32_t ns)
+{
+    mr_delay_tick(mr_delay_ns_to_tick(ns));
+}
+
+mr_uint32_t mr_delay_ns_to_tick(mr_uint32_t ns)
+{
+    /* A tick is one HCLK cycle, mr_delay_tick scales it to the SysTick clock in use */
+    return (mr_uint32_t)(((mr_uint64_t)ns * MR_BSP_SYSCLK_FREQ) / 1000000000u);
+}
+
+void mr_delay_tick(mr_uint32_t tick)
+{
+    mr_uint32_t ctlr = SysTick->CTLR, scale = 0, reload = 0, last = 0, now = 0, delta = 0, elapsed = 0;
+    mr_uint64_t cmp = SysTick->CMP;
+
+    /* Borrow a stopped SysTick (Delay_Us leaves it so) counting up freely, it is handed back as found */
+    if ((ctlr & (1 << 0)) == 0)
+    {
+        SysTick->CTLR = ctlr & ~((1 << 4) | (1 << 3) | (1 << 1));
+        SysTick->CMP = (mr_uint64_t)-1;
+        SysTick->CTLR |= (1 << 0);
+    }
+
+    /* STCLK selects HCLK or HCLK/8, an auto-reload (os tick) wraps the counter after CMP */
+    scale = (SysTick->CTLR & (1 << 2)) ? 1 : 8;
+    reload = (SysTick->CTLR & (1 << 3)) ? (mr_uint32_t)SysTick->CMP + 1 : 0;
+
+    /* Busy-wait on the counter, a running SysTick is only read */
+    last = (mr_uint32_t)SysTick->CNT;
+    while (elapsed < tick)
+    {
+        now = (mr_uint32_t)SysTick->CNT;
+        if (SysTick->CTLR & (1 << 4))
+        {
+            delta = (reload != 0 && now > last) ? last + reload - now : last - now;
+        } else
+        {
+            delta = (reload != 0 && now < last) ? now + reload - last : now - last;
+        }
+        elapsed += delta * scale;
+        last = now;
+    }
+
+    /* Hand the borrowed SysTick back stopped */
+    if ((ctlr & (1 << 0)) == 0)
+    {
+        SysTick->CTLR = ctlr;
+        SysTick->CMP = cmp;
+    }
+}
+
 void mr_delay_us(mr_size_t us)
 {
     Delay_Us(us);
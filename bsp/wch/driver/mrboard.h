@@ -58,6 +58,12 @@ extern "C" {
 #define MR_BSP_I2C_2
 #define MR_BSP_I2C_3
 
+/**
+ * @def Bsp hardware i2c
+ */
+#define MR_BSP_HW_I2C_1
+#define MR_BSP_HW_I2C_2
+
 /**
  * @def Bsp spi
  */
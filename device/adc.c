@@ -27,6 +27,233 @@ static mr_uint32_t err_io_adc_read(mr_adc_t adc, mr_off_t channel)
     return 0;
 }
 
+static void err_io_adc_stop_scan(mr_adc_t adc)
+{
+
+}
+
+static const struct mr_adc_filter *mr_adc_get_filter(mr_adc_t adc, mr_off_t channel)
+{
+    static const struct mr_adc_filter default_filter = MR_ADC_FILTER_DEFAULT;
+
+    /* Channels out of the filter table are not filtered */
+    if (channel >= MR_CFG_ADC_FILTER_NUM)
+    {
+        return &default_filter;
+    }
+
+    return &adc->filter[channel];
+}
+
+static mr_uint32_t mr_adc_filter_output(const struct mr_adc_filter *filter, mr_uint32_t sum, mr_uint32_t max)
+{
+    mr_uint8_t shift = 0;
+    mr_int64_t value = 0;
+
+    /* The sum of ratio samples gains log2(ratio) bits, keep the extra resolution bits and drop the rest */
+    while ((1u << shift) < filter->ratio)
+    {
+        shift++;
+    }
+    shift -= filter->bits;
+
+    value = (((mr_int64_t)(sum >> shift) * filter->gain) >> 16) + filter->offset;
+    mr_limit_range(value, 0, (mr_int64_t)max);
+
+    return (mr_uint32_t)value;
+}
+
+static mr_uint32_t mr_adc_read_filter(mr_adc_t adc, mr_off_t channel)
+{
+    const struct mr_adc_filter *filter = mr_adc_get_filter(adc, channel);
+    mr_uint32_t sum = 0;
+    mr_size_t count = 0;
+
+    for (count = 0; count < filter->ratio; count++)
+    {
+        sum += adc->ops->read(adc, channel);
+    }
+
+    return mr_adc_filter_output(filter, sum, MR_UINT32_MAX);
+}
+
+static void mr_adc_put_sample(mr_adc_t adc, void *buffer, mr_size_t index, mr_uint32_t value)
+{
+    mr_uint8_t *packed = MR_NULL;
+
+    switch (adc->format.width)
+    {
+        case MR_ADC_WIDTH_16BIT:
+        {
+            if (value > MR_UINT16_MAX)
+            {
+                value = MR_UINT16_MAX;
+            }
+            ((mr_uint16_t *)buffer)[index] = (mr_uint16_t)value;
+            break;
+        }
+
+        case MR_ADC_WIDTH_12BIT_PACKED:
+        {
+            /* Even samples take the first byte and the low nibble, odd samples the high nibble and the last byte */
+            if (value > 0xfff)
+            {
+                value = 0xfff;
+            }
+            packed = (mr_uint8_t *)buffer + (index / 2) * 3;
+            if ((index & 1) == 0)
+            {
+                packed[0] = (mr_uint8_t)value;
+                packed[1] = (mr_uint8_t)(value >> 8);
+            } else
+            {
+                packed[1] |= (mr_uint8_t)(value << 4);
+                packed[2] = (mr_uint8_t)(value >> 4);
+            }
+            break;
+        }
+
+        default:
+        {
+            ((mr_uint32_t *)buffer)[index] = value;
+            break;
+        }
+    }
+}
+
+static mr_size_t mr_adc_scan_filter(mr_adc_t adc, mr_uint16_t *buffer, mr_size_t count)
+{
+    mr_uint32_t sum[32];
+    mr_uint32_t mask = adc->config.channel._mask;
+    mr_size_t channels = adc->scan_channels;
+    mr_size_t ratio = adc->scan_ratio;
+    const mr_uint16_t *input = buffer;
+    mr_uint16_t *output = buffer;
+    mr_size_t frames = count / (channels * ratio);
+    mr_size_t frame = 0, scan = 0, i = 0;
+    mr_off_t channel = 0;
+
+    for (frame = 0; frame < frames; frame++)
+    {
+        /* Boxcar sum over ratio scans, the inner loop runs over contiguous samples */
+        for (i = 0; i < channels; i++)
+        {
+            sum[i] = 0;
+        }
+        for (scan = 0; scan < ratio; scan++)
+        {
+            for (i = 0; i < channels; i++)
+            {
+                sum[i] += input[i];
+            }
+            input += channels;
+        }
+
+        /* Decimate and calibrate in place, the output never overtakes the input */
+        for (i = 0, channel = 0; i < channels; i++, channel++)
+        {
+            while ((mask & (1u << channel)) == 0)
+            {
+                channel++;
+            }
+            output[i] = (mr_uint16_t)mr_adc_filter_output(mr_adc_get_filter(adc, channel), sum[i], MR_UINT16_MAX);
+        }
+        output += channels;
+    }
+
+    return frames * channels;
+}
+
+static mr_err_t mr_adc_set_filter(mr_adc_t adc, mr_adc_filter_t filter)
+{
+    /* The filter is fixed while scanning */
+    if (adc->scan.count != 0)
+    {
+        return MR_ERR_BUSY;
+    }
+
+    /* The ratio is a power of 2, the extra bits are at most half of log2(ratio) */
+    if (filter->channel >= MR_CFG_ADC_FILTER_NUM
+        || filter->ratio == 0 || filter->ratio > 256 || (filter->ratio & (filter->ratio - 1)) != 0
+        || (1u << (2 * filter->bits)) > filter->ratio)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    adc->filter[filter->channel] = *filter;
+    return MR_ERR_OK;
+}
+
+static mr_err_t mr_adc_stop_scan(mr_adc_t adc)
+{
+    if (adc->scan.count != 0)
+    {
+        adc->ops->stop_scan(adc);
+        adc->scan.count = 0;
+    }
+
+    return MR_ERR_OK;
+}
+
+static mr_err_t mr_adc_start_scan(mr_adc_t adc, mr_adc_scan_t scan)
+{
+    const struct mr_adc_filter *filter = MR_NULL;
+    mr_size_t channels = 0, ratio = 0, filters = 0;
+    mr_size_t count = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Check if the scan is supported */
+    if (adc->ops->start_scan == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    /* Count the enabled channels, each scan converts all of them */
+    for (count = 0; count < 32; count++)
+    {
+        if (adc->config.channel._mask & (1u << count))
+        {
+            filter = mr_adc_get_filter(adc, (mr_off_t)count);
+
+            /* Scans are interleaved, all channels are decimated by the same ratio */
+            if (ratio != 0 && filter->ratio != ratio)
+            {
+                return MR_ERR_INVALID;
+            }
+            ratio = filter->ratio;
+
+            if (filter->ratio != 1 || filter->offset != 0 || filter->gain != MR_ADC_FILTER_GAIN_UNIT)
+            {
+                filters++;
+            }
+            channels++;
+        }
+    }
+
+    /* Each half holds whole decimated frames */
+    if (scan->buffer == MR_NULL || channels == 0
+        || scan->count == 0 || scan->count % (2 * channels * ratio) != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+    adc->scan_channels = channels;
+
+    /* No filter, the raw samples are handed out */
+    adc->scan_ratio = (filters != 0) ? ratio : 0;
+
+    /* Restart the running scan */
+    mr_adc_stop_scan(adc);
+
+    adc->scan = *scan;
+    ret = adc->ops->start_scan(adc, &adc->scan);
+    if (ret != MR_ERR_OK)
+    {
+        adc->scan.count = 0;
+    }
+
+    return ret;
+}
+
 static mr_err_t mr_adc_open(mr_device_t device)
 {
     mr_adc_t adc = (mr_adc_t)device;
@@ -38,6 +265,8 @@ static mr_err_t mr_adc_close(mr_device_t device)
 {
     mr_adc_t adc = (mr_adc_t)device;
 
+    mr_adc_stop_scan(adc);
+
     /* Disable all channel */
     adc->config.channel._mask = 0;
 
@@ -56,6 +285,13 @@ static mr_err_t mr_adc_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_adc_config_t config = (mr_adc_config_t)args;
+
+                /* The scan sequence is fixed while scanning */
+                if (adc->scan.count != 0)
+                {
+                    return MR_ERR_BUSY;
+                }
+
                 ret = adc->ops->channel_configure(adc, config);
                 if (ret == MR_ERR_OK)
                 {
@@ -77,6 +313,76 @@ static mr_err_t mr_adc_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_INVALID;
         }
 
+        case MR_DEVICE_CTRL_ADC_SET_FILTER:
+        {
+            if (args)
+            {
+                return mr_adc_set_filter(adc, (mr_adc_filter_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_ADC_GET_FILTER:
+        {
+            if (args)
+            {
+                mr_adc_filter_t filter = (mr_adc_filter_t)args;
+                mr_off_t channel = filter->channel;
+
+                *filter = *mr_adc_get_filter(adc, channel);
+                filter->channel = channel;
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_ADC_SET_FORMAT:
+        {
+            if (args)
+            {
+                mr_adc_format_t format = (mr_adc_format_t)args;
+
+                if (format->width > MR_ADC_WIDTH_12BIT_PACKED)
+                {
+                    return MR_ERR_INVALID;
+                }
+                adc->format = *format;
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_ADC_GET_FORMAT:
+        {
+            if (args)
+            {
+                mr_adc_format_t format = (mr_adc_format_t)args;
+                *format = adc->format;
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_SET_RX_CB:
+        {
+            device->rx_cb = (mr_device_cb_t)args;
+            return MR_ERR_OK;
+        }
+
+        case MR_DEVICE_CTRL_ADC_START_SCAN:
+        {
+            if (args)
+            {
+                return mr_adc_start_scan(adc, (mr_adc_scan_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_ADC_STOP_SCAN:
+        {
+            return mr_adc_stop_scan(adc);
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
@@ -85,21 +391,85 @@ static mr_err_t mr_adc_ioctl(mr_device_t device, int cmd, void *args)
 static mr_ssize_t mr_adc_read(mr_device_t device, mr_off_t pos, void *buffer, mr_size_t size)
 {
     mr_adc_t adc = (mr_adc_t)device;
-    mr_uint32_t *read_buffer = (mr_uint32_t *)buffer;
-    mr_size_t read_size = 0;
+    mr_uint32_t mask = (mr_uint32_t)pos;
+    mr_size_t channels = 0, count = 0, i = 0;
+    mr_off_t channel = pos;
+
+    if (adc->format.pos == MR_ADC_POS_MASK)
+    {
+        /* Count the channels of a frame */
+        for (i = 0; i < 32; i++)
+        {
+            if (mask & (1u << i))
+            {
+                channels++;
+            }
+        }
+    } else if (pos >= 0)
+    {
+        channels = 1;
+    }
 
-    if (pos < 0)
+    if (channels == 0)
     {
         return MR_ERR_INVALID;
     }
 
-    while ((read_size += sizeof(*read_buffer)) <= size)
+    /* The converter belongs to the scan */
+    if (adc->scan.count != 0)
+    {
+        return MR_ERR_BUSY;
+    }
+
+    /* Samples that fit in the buffer, whole frames only */
+    switch (adc->format.width)
+    {
+        case MR_ADC_WIDTH_16BIT:
+        {
+            count = size / sizeof(mr_uint16_t);
+            break;
+        }
+
+        case MR_ADC_WIDTH_12BIT_PACKED:
+        {
+            count = size * 2 / 3;
+            break;
+        }
+
+        default:
+        {
+            count = size / sizeof(mr_uint32_t);
+            break;
+        }
+    }
+    count -= count % channels;
+
+    for (i = 0; i < count; i++)
     {
-        *read_buffer = adc->ops->read(adc, pos);
-        read_buffer++;
+        /* Frames are interleaved in ascending channel order */
+        if (adc->format.pos == MR_ADC_POS_MASK)
+        {
+            channel = (i % channels == 0) ? 0 : (channel + 1);
+            while ((mask & (1u << channel)) == 0)
+            {
+                channel++;
+            }
+        }
+
+        mr_adc_put_sample(adc, buffer, i, mr_adc_read_filter(adc, channel));
     }
 
-    return (mr_ssize_t)read_size;
+    switch (adc->format.width)
+    {
+        case MR_ADC_WIDTH_16BIT:
+            return (mr_ssize_t)(count * sizeof(mr_uint16_t));
+
+        case MR_ADC_WIDTH_12BIT_PACKED:
+            return (mr_ssize_t)((count * 3 + 1) / 2);
+
+        default:
+            return (mr_ssize_t)(count * sizeof(mr_uint32_t));
+    }
 }
 
 /**
@@ -122,6 +492,9 @@ mr_err_t mr_adc_device_add(mr_adc_t adc, const char *name, struct mr_adc_ops *op
             mr_adc_read,
             MR_NULL,
         };
+    struct mr_adc_format default_format = MR_ADC_FORMAT_DEFAULT;
+    struct mr_adc_filter default_filter = MR_ADC_FILTER_DEFAULT;
+    mr_size_t count = 0;
 
     MR_ASSERT(adc != MR_NULL);
     MR_ASSERT(name != MR_NULL);
@@ -129,15 +502,76 @@ mr_err_t mr_adc_device_add(mr_adc_t adc, const char *name, struct mr_adc_ops *op
 
     /* Initialize the private fields */
     adc->config.channel._mask = 0;
+    adc->format = default_format;
+    adc->scan.buffer = MR_NULL;
+    adc->scan.count = 0;
+    adc->scan.rate = 0;
+    adc->scan_channels = 0;
+    adc->scan_ratio = 0;
+    for (count = 0; count < MR_CFG_ADC_FILTER_NUM; count++)
+    {
+        adc->filter[count] = default_filter;
+        adc->filter[count].channel = count;
+    }
 
     /* Protect every operation of the adc device */
     ops->configure = ops->configure ? ops->configure : err_io_adc_configure;
     ops->channel_configure = ops->channel_configure ? ops->channel_configure : err_io_adc_channel_configure;
     ops->read = ops->read ? ops->read : err_io_adc_read;
+    ops->stop_scan = ops->stop_scan ? ops->stop_scan : err_io_adc_stop_scan;
     adc->ops = ops;
 
     /* Add the device */
     return mr_device_add(&adc->device, name, Mr_Device_Type_ADC, MR_DEVICE_OFLAG_RDONLY, &device_ops, data);
 }
 
+/**
+ * @brief This function service interrupt routine of the adc device.
+ *
+ * @param adc The adc device.
+ * @param event The interrupt event.
+ */
+void mr_adc_device_isr(mr_adc_t adc, mr_uint32_t event)
+{
+    struct mr_adc_scan_block block;
+
+    MR_ASSERT(adc != MR_NULL);
+
+    switch (event & MR_ADC_EVENT_MASK)
+    {
+        case MR_ADC_EVENT_SCAN_HALF:
+        case MR_ADC_EVENT_SCAN_FULL:
+        {
+            if (adc->scan.count == 0)
+            {
+                break;
+            }
+
+            /* The dma keeps filling the other half while the completed half is handed out */
+            block.count = adc->scan.count / 2;
+            block.buffer = adc->scan.buffer;
+            if ((event & MR_ADC_EVENT_MASK) == MR_ADC_EVENT_SCAN_FULL)
+            {
+                block.buffer += block.count;
+            }
+
+            /* Filter the completed half */
+            if (adc->scan_ratio != 0)
+            {
+                block.count = mr_adc_scan_filter(adc, block.buffer, block.count);
+            }
+
+            /* Call the receiving completion function */
+            if (adc->device.rx_cb != MR_NULL)
+            {
+                adc->device.rx_cb(&adc->device, &block);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
 #endif
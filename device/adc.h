@@ -19,6 +19,49 @@ extern "C" {
 
 #if (MR_CFG_ADC == MR_CFG_ENABLE)
 
+/**
+ * @def ADC device control scan flag
+ */
+#define MR_DEVICE_CTRL_ADC_START_SCAN   0x01000000
+#define MR_DEVICE_CTRL_ADC_STOP_SCAN    0x02000000
+
+/**
+ * @def ADC device control filter flag
+ */
+#define MR_DEVICE_CTRL_ADC_SET_FILTER   0x03000000
+#define MR_DEVICE_CTRL_ADC_GET_FILTER   0x04000000
+
+/**
+ * @def ADC device control format flag
+ */
+#define MR_DEVICE_CTRL_ADC_SET_FORMAT   0x05000000
+#define MR_DEVICE_CTRL_ADC_GET_FORMAT   0x06000000
+
+/**
+ * @def ADC device sample width
+ */
+#define MR_ADC_WIDTH_32BIT              0
+#define MR_ADC_WIDTH_16BIT              1
+#define MR_ADC_WIDTH_12BIT_PACKED       2                           /* 2 samples in 3 bytes */
+
+/**
+ * @def ADC device read position
+ */
+#define MR_ADC_POS_CHANNEL              0                           /* Position is a channel */
+#define MR_ADC_POS_MASK                 1                           /* Position is a channel mask */
+
+/**
+ * @def ADC device filter gain (Q16)
+ */
+#define MR_ADC_FILTER_GAIN_UNIT         0x10000
+
+/**
+ * @def ADC device interrupt event
+ */
+#define MR_ADC_EVENT_SCAN_HALF          0x10000000
+#define MR_ADC_EVENT_SCAN_FULL          0x20000000
+#define MR_ADC_EVENT_MASK               0xf0000000
+
 /**
  * @struct ADC device config
  */
@@ -28,6 +71,74 @@ struct mr_adc_config
 };
 typedef struct mr_adc_config *mr_adc_config_t;
 
+/**
+ * @def ADC device default filter
+ */
+#define MR_ADC_FILTER_DEFAULT           \
+{                                       \
+    0,                                  \
+    1,                                  \
+    0,                                  \
+    0,                                  \
+    0,                                  \
+    MR_ADC_FILTER_GAIN_UNIT,            \
+}
+
+/**
+ * @struct ADC device filter
+ */
+struct mr_adc_filter
+{
+    mr_uint32_t channel: 5;                                         /* Channel */
+    mr_uint32_t ratio: 9;                                           /* Oversampling ratio (1-256, power of 2) */
+    mr_uint32_t bits: 4;                                            /* Extra resolution bits */
+    mr_uint32_t reserved: 14;
+    mr_int32_t offset;                                              /* Offset calibration */
+    mr_uint32_t gain;                                               /* Gain calibration (Q16) */
+};
+typedef struct mr_adc_filter *mr_adc_filter_t;
+
+/**
+ * @def ADC device default format
+ */
+#define MR_ADC_FORMAT_DEFAULT           \
+{                                       \
+    MR_ADC_WIDTH_32BIT,                 \
+    MR_ADC_POS_CHANNEL,                 \
+}
+
+/**
+ * @struct ADC device format
+ */
+struct mr_adc_format
+{
+    mr_uint32_t width: 2;
+    mr_uint32_t pos: 1;
+    mr_uint32_t reserved: 29;
+};
+typedef struct mr_adc_format *mr_adc_format_t;
+
+/**
+ * @struct ADC device scan
+ */
+struct mr_adc_scan
+{
+    mr_uint16_t *buffer;                                            /* Double buffer (both halves) */
+    mr_size_t count;                                                /* Samples of both halves */
+    mr_uint32_t rate;                                               /* Scan rate (Hz, 0: external trigger) */
+};
+typedef struct mr_adc_scan *mr_adc_scan_t;
+
+/**
+ * @struct ADC device scan block
+ */
+struct mr_adc_scan_block
+{
+    mr_uint16_t *buffer;                                            /* Completed half */
+    mr_size_t count;                                                /* Samples of the half */
+};
+typedef struct mr_adc_scan_block *mr_adc_scan_block_t;
+
 typedef struct mr_adc *mr_adc_t;
 
 /**
@@ -38,6 +149,10 @@ struct mr_adc_ops
     mr_err_t (*configure)(mr_adc_t adc, mr_state_t state);
     mr_err_t (*channel_configure)(mr_adc_t adc, mr_adc_config_t config);
     mr_uint32_t (*read)(mr_adc_t adc, mr_off_t channel);
+
+    /* Scan operations */
+    mr_err_t (*start_scan)(mr_adc_t adc, mr_adc_scan_t scan);
+    void (*stop_scan)(mr_adc_t adc);
 };
 
 /**
@@ -48,6 +163,11 @@ struct mr_adc
     struct mr_device device;
 
     struct mr_adc_config config;
+    struct mr_adc_format format;
+    struct mr_adc_scan scan;
+    struct mr_adc_filter filter[MR_CFG_ADC_FILTER_NUM];
+    mr_size_t scan_channels;
+    mr_size_t scan_ratio;
 
     const struct mr_adc_ops *ops;
 };
@@ -57,6 +177,7 @@ struct mr_adc
  * @{
  */
 mr_err_t mr_adc_device_add(mr_adc_t adc, const char *name, struct mr_adc_ops *ops, void *data);
+void mr_adc_device_isr(mr_adc_t adc, mr_uint32_t event);
 /** @} */
 
 #endif
@@ -27,6 +27,73 @@ static void err_io_dac_write(mr_dac_t dac, mr_off_t channel, mr_uint32_t value)
 
 }
 
+static void err_io_dac_stop_stream(mr_dac_t dac)
+{
+
+}
+
+static mr_err_t mr_dac_stop_stream(mr_dac_t dac)
+{
+    if (dac->stream.count != 0)
+    {
+        dac->ops->stop_stream(dac);
+        dac->stream.count = 0;
+    }
+
+    return MR_ERR_OK;
+}
+
+static mr_err_t mr_dac_start_stream(mr_dac_t dac, mr_dac_stream_t stream)
+{
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Check if the stream is supported */
+    if (dac->ops->start_stream == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    /* The buffer is split into two halves */
+    if (stream->buffer == MR_NULL || stream->rate == 0 || dac->config.channel._mask == 0
+        || stream->count < 2 || stream->count % 2 != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* Restart the running stream */
+    mr_dac_stop_stream(dac);
+
+    dac->stream = *stream;
+    ret = dac->ops->start_stream(dac, &dac->stream);
+    if (ret != MR_ERR_OK)
+    {
+        dac->stream.count = 0;
+    }
+
+    return ret;
+}
+
+static mr_uint16_t mr_dac_table_value(mr_int32_t wave, mr_uint16_t amplitude, mr_uint16_t offset)
+{
+    mr_int32_t value = offset + ((wave * amplitude + (1 << 14)) >> 15);
+
+    mr_limit_range(value, 0, MR_UINT16_MAX);
+    return (mr_uint16_t)value;
+}
+
+static mr_int32_t mr_dac_sine_quarter(mr_int32_t x)
+{
+    mr_int32_t x2 = (x * x) >> 15;
+    mr_int32_t y = 0;
+
+    /* Fitted odd 5th order polynomial of sin(x * pi / 2) over a quarter period, exact at both ends (Q15) */
+    y = 20966 - ((x2 * 2295) >> 15);
+    y = 51439 - ((x2 * y) >> 15);
+    y = (x * y) >> 15;
+
+    return (y > 32767) ? 32767 : y;
+}
+
 static mr_err_t mr_dac_open(mr_device_t device)
 {
     mr_dac_t dac = (mr_dac_t)device;
@@ -38,6 +105,8 @@ static mr_err_t mr_dac_close(mr_device_t device)
 {
     mr_dac_t dac = (mr_dac_t)device;
 
+    mr_dac_stop_stream(dac);
+
     /* Disable all channel */
     dac->config.channel._mask = 0;
 
@@ -56,6 +125,13 @@ static mr_err_t mr_dac_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_dac_config_t config = (mr_dac_config_t)args;
+
+                /* The output belongs to the stream */
+                if (dac->stream.count != 0)
+                {
+                    return MR_ERR_BUSY;
+                }
+
                 ret = dac->ops->channel_configure(dac, config);
                 if (ret == MR_ERR_OK)
                 {
@@ -77,6 +153,26 @@ static mr_err_t mr_dac_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_INVALID;
         }
 
+        case MR_DEVICE_CTRL_SET_TX_CB:
+        {
+            device->tx_cb = (mr_device_cb_t)args;
+            return MR_ERR_OK;
+        }
+
+        case MR_DEVICE_CTRL_DAC_START_STREAM:
+        {
+            if (args)
+            {
+                return mr_dac_start_stream(dac, (mr_dac_stream_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_DAC_STOP_STREAM:
+        {
+            return mr_dac_stop_stream(dac);
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
@@ -93,6 +189,12 @@ static mr_ssize_t mr_dac_write(mr_device_t device, mr_off_t pos, const void *buf
         return MR_ERR_INVALID;
     }
 
+    /* The output belongs to the stream */
+    if (dac->stream.count != 0)
+    {
+        return MR_ERR_BUSY;
+    }
+
     while ((write_size += sizeof(*write_buffer)) <= size)
     {
         dac->ops->write(dac, pos, *write_buffer);
@@ -129,15 +231,255 @@ mr_err_t mr_dac_device_add(mr_dac_t dac, const char *name, struct mr_dac_ops *op
 
     /* Initialize the private fields */
     dac->config.channel._mask = 0;
+    dac->stream.buffer = MR_NULL;
+    dac->stream.count = 0;
+    dac->stream.rate = 0;
 
     /* Protect every operation of the dac device */
     ops->configure = ops->configure ? ops->configure : err_io_dac_configure;
     ops->channel_configure = ops->channel_configure ? ops->channel_configure : err_io_dac_channel_configure;
     ops->write = ops->write ? ops->write : err_io_dac_write;
+    ops->stop_stream = ops->stop_stream ? ops->stop_stream : err_io_dac_stop_stream;
     dac->ops = ops;
 
     /* Add the device */
     return mr_device_add(&dac->device, name, Mr_Device_Type_DAC, MR_DEVICE_OFLAG_WRONLY, &device_ops, data);
 }
 
+/**
+ * @brief This function service interrupt routine of the dac device.
+ *
+ * @param dac The dac device.
+ * @param event The interrupt event.
+ */
+void mr_dac_device_isr(mr_dac_t dac, mr_uint32_t event)
+{
+    struct mr_dac_stream_block block;
+
+    MR_ASSERT(dac != MR_NULL);
+
+    switch (event & MR_DAC_EVENT_MASK)
+    {
+        case MR_DAC_EVENT_STREAM_HALF:
+        case MR_DAC_EVENT_STREAM_FULL:
+        {
+            if (dac->stream.count == 0)
+            {
+                break;
+            }
+
+            /* The dma keeps sending the other half while the sent half is refilled */
+            block.count = dac->stream.count / 2;
+            block.buffer = dac->stream.buffer;
+            if ((event & MR_DAC_EVENT_MASK) == MR_DAC_EVENT_STREAM_FULL)
+            {
+                block.buffer += block.count;
+            }
+
+            /* Call the sending completion function */
+            if (dac->device.tx_cb != MR_NULL)
+            {
+                dac->device.tx_cb(&dac->device, &block);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief This function builds a sine table.
+ *
+ * @param table The table to be built.
+ * @param size The size of the table (one period).
+ * @param amplitude The amplitude of the sine.
+ * @param offset The offset of the sine.
+ */
+void mr_dac_table_sine(mr_uint16_t *table, mr_size_t size, mr_uint16_t amplitude, mr_uint16_t offset)
+{
+    mr_uint32_t phase = 0;
+    mr_int32_t x = 0;
+    mr_size_t count = 0;
+
+    MR_ASSERT(table != MR_NULL);
+    MR_ASSERT(size != 0);
+
+    for (count = 0; count < size; count++)
+    {
+        /* 16-bit phase of the sample, mirrored into the first quarter */
+        phase = (mr_uint32_t)(((mr_uint64_t)count << 16) / size);
+        x = (mr_int32_t)(phase & 0x3fff) << 1;
+        if (phase & 0x4000)
+        {
+            x = 32768 - x;
+        }
+        x = mr_dac_sine_quarter(x);
+
+        table[count] = mr_dac_table_value((phase & 0x8000) ? -x : x, amplitude, offset);
+    }
+}
+
+/**
+ * @brief This function builds a triangle table.
+ *
+ * @param table The table to be built.
+ * @param size The size of the table (one period).
+ * @param amplitude The amplitude of the triangle.
+ * @param offset The offset of the triangle.
+ */
+void mr_dac_table_triangle(mr_uint16_t *table, mr_size_t size, mr_uint16_t amplitude, mr_uint16_t offset)
+{
+    mr_uint32_t phase = 0;
+    mr_int32_t x = 0;
+    mr_size_t count = 0;
+
+    MR_ASSERT(table != MR_NULL);
+    MR_ASSERT(size != 0);
+
+    for (count = 0; count < size; count++)
+    {
+        /* Rise over the first and last quarters, fall over the middle half, in phase with the sine */
+        phase = (mr_uint32_t)(((mr_uint64_t)count << 16) / size);
+        if (phase < 0x4000)
+        {
+            x = (mr_int32_t)phase << 1;
+        } else if (phase < 0xc000)
+        {
+            x = 32768 - (((mr_int32_t)phase - 0x4000) << 1);
+        } else
+        {
+            x = (((mr_int32_t)phase - 0xc000) << 1) - 32768;
+        }
+        mr_limit_range(x, -32767, 32767);
+
+        table[count] = mr_dac_table_value(x, amplitude, offset);
+    }
+}
+
+/**
+ * @brief This function builds an arbitrary table from points.
+ *
+ * @param table The table to be built.
+ * @param size The size of the table (one period).
+ * @param points The points evenly spaced over one period (Q15, -32767 to 32767).
+ * @param num The number of the points.
+ * @param amplitude The amplitude of the waveform.
+ * @param offset The offset of the waveform.
+ *
+ * @note The points are linearly interpolated, the last point joins the first one.
+ */
+void mr_dac_table_points(mr_uint16_t *table,
+                         mr_size_t size,
+                         const mr_int16_t *points,
+                         mr_size_t num,
+                         mr_uint16_t amplitude,
+                         mr_uint16_t offset)
+{
+    mr_uint64_t position = 0;
+    mr_size_t index = 0, fraction = 0, count = 0;
+    mr_int32_t x = 0;
+
+    MR_ASSERT(table != MR_NULL);
+    MR_ASSERT(size != 0);
+    MR_ASSERT(points != MR_NULL);
+    MR_ASSERT(num != 0);
+
+    for (count = 0; count < size; count++)
+    {
+        position = (mr_uint64_t)count * num;
+        index = (mr_size_t)(position / size);
+        fraction = (mr_size_t)(position % size);
+
+        x = points[index];
+        x += (mr_int32_t)(((mr_int64_t)(points[(index + 1) % num] - x) * fraction) / (mr_int64_t)size);
+
+        table[count] = mr_dac_table_value(x, amplitude, offset);
+    }
+}
+
+/**
+ * @brief This function initialize the direct digital synthesizer.
+ *
+ * @param dds The direct digital synthesizer to be initialized.
+ * @param table The table of one period.
+ * @param size The size of the table (power of 2).
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ */
+mr_err_t mr_dac_dds_init(mr_dac_dds_t dds, const mr_uint16_t *table, mr_size_t size)
+{
+    mr_uint8_t bits = 0;
+
+    MR_ASSERT(dds != MR_NULL);
+    MR_ASSERT(table != MR_NULL);
+
+    if (size < 2 || (size & (size - 1)) != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    while ((1u << bits) < size)
+    {
+        bits++;
+    }
+
+    dds->table = table;
+    dds->bits = bits;
+    dds->phase = 0;
+    dds->step = 0;
+
+    return MR_ERR_OK;
+}
+
+/**
+ * @brief This function set the frequency of the direct digital synthesizer.
+ *
+ * @param dds The direct digital synthesizer.
+ * @param freq The output frequency (Hz).
+ * @param rate The sample rate (Hz).
+ */
+void mr_dac_dds_set_freq(mr_dac_dds_t dds, mr_uint32_t freq, mr_uint32_t rate)
+{
+    MR_ASSERT(dds != MR_NULL);
+    MR_ASSERT(rate != 0);
+
+    /* One period is a full turn of the 32-bit phase */
+    dds->step = (mr_uint32_t)(((mr_uint64_t)freq << 32) / rate);
+}
+
+/**
+ * @brief This function fills samples from the direct digital synthesizer.
+ *
+ * @param dds The direct digital synthesizer.
+ * @param buffer The buffer to be filled.
+ * @param count The number of the samples.
+ *
+ * @note Call it from the stream callback to refill the sent half.
+ */
+void mr_dac_dds_fill(mr_dac_dds_t dds, mr_uint16_t *buffer, mr_size_t count)
+{
+    const mr_uint16_t *table = MR_NULL;
+    mr_uint32_t phase = 0, step = 0;
+    mr_uint8_t shift = 0;
+    mr_size_t i = 0;
+
+    MR_ASSERT(dds != MR_NULL);
+    MR_ASSERT(buffer != MR_NULL);
+
+    /* Work on locals, the loop only indexes and accumulates */
+    table = dds->table;
+    shift = 32 - dds->bits;
+    phase = dds->phase;
+    step = dds->step;
+    for (i = 0; i < count; i++)
+    {
+        buffer[i] = table[phase >> shift];
+        phase += step;
+    }
+
+    dds->phase = phase;
+}
+
 #endif
@@ -19,6 +19,19 @@ extern "C" {
 
 #if (MR_CFG_DAC == MR_CFG_ENABLE)
 
+/**
+ * @def DAC device control stream flag
+ */
+#define MR_DEVICE_CTRL_DAC_START_STREAM 0x01000000
+#define MR_DEVICE_CTRL_DAC_STOP_STREAM  0x02000000
+
+/**
+ * @def DAC device interrupt event
+ */
+#define MR_DAC_EVENT_STREAM_HALF        0x10000000
+#define MR_DAC_EVENT_STREAM_FULL        0x20000000
+#define MR_DAC_EVENT_MASK               0xf0000000
+
 /**
  * @struct DAC device config
  */
@@ -28,6 +41,39 @@ struct mr_dac_config
 };
 typedef struct mr_dac_config *mr_dac_config_t;
 
+/**
+ * @struct DAC device stream
+ */
+struct mr_dac_stream
+{
+    mr_uint16_t *buffer;                                            /* Double buffer or circular table */
+    mr_size_t count;                                                /* Samples of the buffer */
+    mr_uint32_t rate;                                               /* Sample rate (Hz) */
+};
+typedef struct mr_dac_stream *mr_dac_stream_t;
+
+/**
+ * @struct DAC device stream block
+ */
+struct mr_dac_stream_block
+{
+    mr_uint16_t *buffer;                                            /* Sent half, free to refill */
+    mr_size_t count;                                                /* Samples of the half */
+};
+typedef struct mr_dac_stream_block *mr_dac_stream_block_t;
+
+/**
+ * @struct DAC direct digital synthesizer
+ */
+struct mr_dac_dds
+{
+    const mr_uint16_t *table;                                       /* One period table */
+    mr_uint8_t bits;                                                /* Log2 of the table size */
+    mr_uint32_t phase;                                              /* Phase accumulator */
+    mr_uint32_t step;                                               /* Phase step per sample */
+};
+typedef struct mr_dac_dds *mr_dac_dds_t;
+
 typedef struct mr_dac *mr_dac_t;
 
 /**
@@ -38,6 +84,10 @@ struct mr_dac_ops
     mr_err_t (*configure)(mr_dac_t dac, mr_state_t state);
     mr_err_t (*channel_configure)(mr_dac_t dac, mr_dac_config_t config);
     void (*write)(mr_dac_t dac, mr_off_t channel, mr_uint32_t value);
+
+    /* Stream operations */
+    mr_err_t (*start_stream)(mr_dac_t dac, mr_dac_stream_t stream);
+    void (*stop_stream)(mr_dac_t dac);
 };
 
 /**
@@ -48,6 +98,7 @@ struct mr_dac
     struct mr_device device;
 
     struct mr_dac_config config;
+    struct mr_dac_stream stream;
 
     const struct mr_dac_ops *ops;
 };
@@ -57,6 +108,18 @@ struct mr_dac
  * @{
  */
 mr_err_t mr_dac_device_add(mr_dac_t dac, const char *name, struct mr_dac_ops *ops, void *data);
+void mr_dac_device_isr(mr_dac_t dac, mr_uint32_t event);
+void mr_dac_table_sine(mr_uint16_t *table, mr_size_t size, mr_uint16_t amplitude, mr_uint16_t offset);
+void mr_dac_table_triangle(mr_uint16_t *table, mr_size_t size, mr_uint16_t amplitude, mr_uint16_t offset);
+void mr_dac_table_points(mr_uint16_t *table,
+                         mr_size_t size,
+                         const mr_int16_t *points,
+                         mr_size_t num,
+                         mr_uint16_t amplitude,
+                         mr_uint16_t offset);
+mr_err_t mr_dac_dds_init(mr_dac_dds_t dds, const mr_uint16_t *table, mr_size_t size);
+void mr_dac_dds_set_freq(mr_dac_dds_t dds, mr_uint32_t freq, mr_uint32_t rate);
+void mr_dac_dds_fill(mr_dac_dds_t dds, mr_uint16_t *buffer, mr_size_t count);
 /** @} */
 
 #endif
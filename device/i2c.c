@@ -12,9 +12,6 @@
 
 #if (MR_CFG_I2C == MR_CFG_ENABLE)
 
-#define MR_I2C_RD                       0
-#define MR_I2C_WR                       1
-
 static mr_err_t err_io_i2c_configure(mr_i2c_bus_t i2c_bus, mr_i2c_config_t config)
 {
     return MR_ERR_IO;
@@ -30,9 +27,9 @@ static void err_io_i2c_stop(mr_i2c_bus_t i2c_bus)
 
 }
 
-static void err_io_i2c_write(mr_i2c_bus_t i2c_bus, mr_uint8_t data)
+static mr_err_t err_io_i2c_write(mr_i2c_bus_t i2c_bus, mr_uint8_t data)
 {
-
+    return MR_ERR_IO;
 }
 
 static mr_uint8_t err_io_i2c_read(mr_i2c_bus_t i2c_bus, mr_state_t ack)
@@ -58,13 +55,15 @@ static mr_err_t mr_i2c_device_take_bus(mr_i2c_device_t i2c_device)
         return ret;
     }
 
-    /* Check if the i2c-bus owner is different from the current one */
-    if (mr_mutex_get_owner(&i2c_bus->lock) != i2c_bus->owner)
+    /* Check if the i2c-bus owner or its host/slave mode is different from the current one */
+    if (mr_mutex_get_owner(&i2c_bus->lock) != i2c_bus->owner
+        || i2c_device->config.host_slave != i2c_bus->config.host_slave)
     {
-        /* If the configuration is different, the i2c-bus is reconfigured */
+        /* If the configuration is different, the i2c-bus is reconfigured, a slave also takes its own address */
         if (i2c_device->config.baud_rate != i2c_bus->config.baud_rate
             || i2c_device->config.host_slave != i2c_bus->config.host_slave
-            || i2c_device->config.addr_bits != i2c_bus->config.addr_bits)
+            || i2c_device->config.addr_bits != i2c_bus->config.addr_bits
+            || i2c_device->config.host_slave == MR_I2C_SLAVE)
         {
             ret = i2c_bus->ops->configure(i2c_bus, &i2c_device->config);
             if (ret != MR_ERR_OK)
@@ -83,12 +82,112 @@ static mr_err_t mr_i2c_device_take_bus(mr_i2c_device_t i2c_device)
     return MR_ERR_OK;
 }
 
+static void mr_i2c_bus_start_request(mr_i2c_bus_t i2c_bus)
+{
+    mr_i2c_request_t request = MR_NULL;
+    mr_err_t ret = MR_ERR_OK;
+
+    while (1)
+    {
+        /* Get the next request, only one request is in progress at a time and only on a free i2c-bus */
+        mr_interrupt_disable();
+        if (i2c_bus->request != MR_NULL
+            || mr_mutex_get_owner(&i2c_bus->lock) != MR_NULL
+            || mr_list_is_empty(&i2c_bus->queue) == MR_TRUE)
+        {
+            mr_interrupt_enable();
+            return;
+        }
+        request = mr_container_of(i2c_bus->queue.next, struct mr_i2c_request, list);
+        mr_list_remove(&request->list);
+        i2c_bus->request = request;
+        mr_interrupt_enable();
+
+        /* Take the i2c-bus for the requesting device */
+        ret = mr_i2c_device_take_bus(request->i2c_device);
+        if (ret == MR_ERR_BUSY)
+        {
+            /* Requeue at the head, it is started again when the i2c-bus is released */
+            mr_interrupt_disable();
+            mr_list_insert_after(&i2c_bus->queue, &request->list);
+            i2c_bus->request = MR_NULL;
+            mr_interrupt_enable();
+
+            if (mr_mutex_get_owner(&i2c_bus->lock) != MR_NULL)
+            {
+                return;
+            }
+            continue;
+        }
+
+        if (ret == MR_ERR_OK)
+        {
+            ret = i2c_bus->ops->start_xfer(i2c_bus, request->i2c_device, request->msgs, request->number);
+            if (ret == MR_ERR_OK)
+            {
+                return;
+            }
+            mr_mutex_release(&i2c_bus->lock, request->i2c_device);
+        }
+
+        /* Failed to start, complete the request with the error */
+        i2c_bus->request = MR_NULL;
+        if (request->done != MR_NULL)
+        {
+            request->done(request, ret);
+        }
+    }
+}
+
 static mr_err_t mr_i2c_device_release_bus(mr_i2c_device_t i2c_device)
 {
     mr_i2c_bus_t i2c_bus = i2c_device->bus;
+    mr_err_t ret = MR_ERR_OK;
 
     /* Release the mutex lock of the i2c-bus */
-    return mr_mutex_release(&i2c_bus->lock, i2c_device);
+    ret = mr_mutex_release(&i2c_bus->lock, i2c_device);
+
+    /* Start the queued asynchronous requests once the i2c-bus is free */
+    if (ret == MR_ERR_OK && i2c_bus->ops->start_xfer != MR_NULL)
+    {
+        mr_i2c_bus_start_request(i2c_bus);
+    }
+    return ret;
+}
+
+static void mr_i2c_device_flush_request(mr_i2c_device_t i2c_device)
+{
+    mr_i2c_bus_t i2c_bus = i2c_device->bus;
+    mr_i2c_request_t request = MR_NULL;
+    struct mr_list flush;
+    mr_list_t node = MR_NULL, next = MR_NULL;
+
+    mr_list_init(&flush);
+
+    /* Take the queued requests of the i2c-device out of the i2c-bus queue */
+    mr_interrupt_disable();
+    for (node = i2c_bus->queue.next; node != &i2c_bus->queue; node = next)
+    {
+        next = node->next;
+        request = mr_container_of(node, struct mr_i2c_request, list);
+        if (request->i2c_device == i2c_device)
+        {
+            mr_list_remove(node);
+            mr_list_insert_before(&flush, node);
+        }
+    }
+    mr_interrupt_enable();
+
+    /* Complete them with the error, they are never started */
+    while (mr_list_is_empty(&flush) == MR_FALSE)
+    {
+        request = mr_container_of(flush.next, struct mr_i2c_request, list);
+        mr_list_remove(&request->list);
+        if (request->done != MR_NULL)
+        {
+            request->done(request, MR_ERR_IO);
+        }
+    }
 }
 
 static mr_err_t mr_i2c_device_connect_bus(mr_i2c_device_t i2c_device, const char *name)
@@ -111,6 +210,13 @@ static mr_err_t mr_i2c_device_connect_bus(mr_i2c_device_t i2c_device, const char
         /* Disconnect the old i2c-bus */
         if (i2c_device->bus != MR_NULL)
         {
+            /* The request in progress holds the i2c-bus until the driver completes it */
+            if (i2c_device->bus->request != MR_NULL && i2c_device->bus->request->i2c_device == i2c_device)
+            {
+                return MR_ERR_BUSY;
+            }
+            mr_i2c_device_flush_request(i2c_device);
+
             /* Release the mutex */
             if (i2c_device->config.host_slave == MR_I2C_SLAVE)
             {
@@ -150,18 +256,137 @@ static mr_err_t mr_i2c_device_connect_bus(mr_i2c_device_t i2c_device, const char
     return MR_ERR_OK;
 }
 
-MR_INLINE void mr_i2c_device_send_address(mr_i2c_device_t i2c_device, mr_state_t rw)
+static mr_err_t mr_i2c_device_send_address(mr_i2c_device_t i2c_device, mr_uint16_t flags)
 {
     mr_i2c_bus_t i2c_bus = i2c_device->bus;
+    mr_uint8_t header = 0;
+    mr_err_t ret = MR_ERR_OK;
 
     i2c_bus->ops->start(i2c_bus);
-    if (rw)
+    if ((flags & MR_I2C_M_ADDR_10BIT) || i2c_device->config.addr_bits == MR_I2C_ADDR_BITS_10)
     {
-        i2c_bus->ops->write(i2c_bus, (mr_uint8_t)(i2c_device->address << 1));
+        /* 10-bit address: header(11110xx) + low byte, the read needs a repeated start */
+        header = (mr_uint8_t)(0xf0 | ((i2c_device->address >> 7) & 0x06));
+        ret = i2c_bus->ops->write(i2c_bus, header);
+        if (ret != MR_ERR_OK)
+        {
+            return ret;
+        }
+        ret = i2c_bus->ops->write(i2c_bus, (mr_uint8_t)i2c_device->address);
+        if (ret != MR_ERR_OK || (flags & MR_I2C_M_RD) == 0)
+        {
+            return ret;
+        }
+        i2c_bus->ops->start(i2c_bus);
+        return i2c_bus->ops->write(i2c_bus, (mr_uint8_t)(header | 0x01));
+    }
+
+    if (flags & MR_I2C_M_RD)
+    {
+        return i2c_bus->ops->write(i2c_bus, (mr_uint8_t)(i2c_device->address << 1 | 0x01));
     } else
     {
-        i2c_bus->ops->write(i2c_bus, (mr_uint8_t)(i2c_device->address << 1 | 0x01));
+        return i2c_bus->ops->write(i2c_bus, (mr_uint8_t)(i2c_device->address << 1));
+    }
+}
+
+static mr_err_t mr_i2c_device_transfer_msg(mr_i2c_device_t i2c_device, mr_i2c_msg_t msg, mr_state_t last_ack)
+{
+    mr_i2c_bus_t i2c_bus = i2c_device->bus;
+    mr_uint8_t *buffer = (mr_uint8_t *)msg->buffer;
+    mr_size_t count = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    if (msg->flags & MR_I2C_M_RD)
+    {
+        for (count = 0; count < msg->size; count++)
+        {
+            buffer[count] = i2c_bus->ops->read(i2c_bus, (count + 1 != msg->size) ? MR_ENABLE : last_ack);
+        }
+    } else
+    {
+        for (count = 0; count < msg->size; count++)
+        {
+            ret = i2c_bus->ops->write(i2c_bus, buffer[count]);
+            if (ret != MR_ERR_OK && (msg->flags & MR_I2C_M_IGNORE_NAK) == 0)
+            {
+                return ret;
+            }
+        }
+    }
+
+    return MR_ERR_OK;
+}
+
+/**
+ * @brief This function transfers a list of messages as one i2c transaction.
+ *
+ * @param i2c_device The i2c device to be transferred.
+ * @param msgs The messages to be transferred.
+ * @param number The number of messages.
+ *
+ * @note Each message starts with a (repeated) start and the address, unless it has the MR_I2C_M_NO_START flag,
+ *       the stop is only sent after the last message. The caller must hold the i2c-bus.
+ *       If the i2c-bus provides the xfer operation, the whole list is handed to it instead of the byte operations.
+ *
+ * @return The number of messages transferred, otherwise an error code.
+ */
+static mr_ssize_t mr_i2c_device_transfer(mr_i2c_device_t i2c_device, mr_i2c_msg_t msgs, mr_size_t number)
+{
+    mr_i2c_bus_t i2c_bus = i2c_device->bus;
+    mr_state_t last_ack = MR_DISABLE;
+    mr_size_t count = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Hardware block transfer */
+    if (i2c_bus->ops->xfer != MR_NULL)
+    {
+        return i2c_bus->ops->xfer(i2c_bus, i2c_device, msgs, number);
+    }
+
+    for (count = 0; count < number; count++)
+    {
+        /* The first message always starts the transaction */
+        if (count == 0 || (msgs[count].flags & MR_I2C_M_NO_START) == 0)
+        {
+            ret = mr_i2c_device_send_address(i2c_device, msgs[count].flags);
+            if (ret != MR_ERR_OK && (msgs[count].flags & MR_I2C_M_IGNORE_NAK) == 0)
+            {
+                break;
+            }
+        }
+
+        /* A read continued by the next message keeps acknowledging its last byte */
+        last_ack = (mr_state_t)(count + 1 < number && (msgs[count + 1].flags & MR_I2C_M_NO_START));
+
+        ret = mr_i2c_device_transfer_msg(i2c_device, &msgs[count], last_ack);
+        if (ret != MR_ERR_OK)
+        {
+            break;
+        }
+    }
+
+    /* Stop transfer */
+    i2c_bus->ops->stop(i2c_bus);
+
+    if (ret != MR_ERR_OK)
+    {
+        return ret;
     }
+    return (mr_ssize_t)number;
+}
+
+MR_INLINE mr_size_t mr_i2c_device_fill_pos(mr_i2c_device_t i2c_device, mr_off_t pos, mr_uint8_t *buffer)
+{
+    mr_size_t bits = 0, count = 0;
+
+    while ((bits += 8) <= i2c_device->config.pos_bits)
+    {
+        buffer[count++] = (mr_uint8_t)pos;
+        pos >>= 8;
+    }
+
+    return count;
 }
 
 static mr_err_t mr_i2c_device_open(mr_device_t device)
@@ -175,6 +400,19 @@ static mr_err_t mr_i2c_device_open(mr_device_t device)
     return MR_ERR_OK;
 }
 
+static mr_err_t mr_i2c_device_close(mr_device_t device)
+{
+    mr_i2c_device_t i2c_device = (mr_i2c_device_t)device;
+
+    /* Fail the requests that are still queued */
+    if (i2c_device->bus != MR_NULL)
+    {
+        mr_i2c_device_flush_request(i2c_device);
+    }
+
+    return MR_ERR_OK;
+}
+
 static mr_err_t mr_i2c_device_ioctl(mr_device_t device, int cmd, void *args)
 {
     mr_i2c_device_t i2c_device = (mr_i2c_device_t)device;
@@ -186,14 +424,20 @@ static mr_err_t mr_i2c_device_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_i2c_config_t config = (mr_i2c_config_t)args;
+                struct mr_i2c_config old_config = i2c_device->config;
                 mr_err_t ret = MR_ERR_OK;
 
-                if (config->host_slave != i2c_device->config.host_slave)
+                /* The bus is taken with the new configuration */
+                i2c_device->config = *config;
+                if (config->host_slave != old_config.host_slave)
                 {
                     if (i2c_device->bus != MR_NULL)
                     {
                         if (config->host_slave == MR_I2C_HOST)
                         {
+                            /* Leave the slave mode before the bus is released */
+                            i2c_device->bus->ops->configure(i2c_device->bus, config);
+                            i2c_device->bus->config = *config;
                             mr_i2c_device_release_bus(i2c_device);
                         } else
                         {
@@ -201,12 +445,12 @@ static mr_err_t mr_i2c_device_ioctl(mr_device_t device, int cmd, void *args)
                             ret = mr_i2c_device_take_bus(i2c_device);
                             if (ret != MR_ERR_OK)
                             {
+                                i2c_device->config = old_config;
                                 return ret;
                             }
                         }
                     }
                 }
-                i2c_device->config = *config;
                 return MR_ERR_OK;
             }
             return MR_ERR_INVALID;
@@ -228,6 +472,98 @@ static mr_err_t mr_i2c_device_ioctl(mr_device_t device, int cmd, void *args)
             return mr_i2c_device_connect_bus(i2c_device, (const char *)args);
         }
 
+        case MR_DEVICE_CTRL_I2C_SET_REG_MAP:
+        {
+            if (args)
+            {
+                struct mr_i2c_reg_map *reg_map = (struct mr_i2c_reg_map *)args;
+
+                /* The register map is used by the slave interrupt */
+                mr_interrupt_disable();
+                i2c_device->reg_map = *reg_map;
+                i2c_device->reg_pos = 0;
+                mr_interrupt_enable();
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_I2C_SUBMIT:
+        {
+            if (args)
+            {
+                mr_i2c_request_t request = (mr_i2c_request_t)args;
+                mr_i2c_bus_t i2c_bus = i2c_device->bus;
+
+                /* Requests can only be submitted by the host */
+                if (i2c_bus == MR_NULL || i2c_device->config.host_slave != MR_I2C_HOST)
+                {
+                    return MR_ERR_UNSUPPORTED;
+                }
+                request->i2c_device = i2c_device;
+
+                /* Without asynchronous operations the request is completed before returning */
+                if (i2c_bus->ops->start_xfer == MR_NULL)
+                {
+                    mr_ssize_t tf_size = 0;
+                    mr_err_t ret = MR_ERR_OK;
+
+                    ret = mr_i2c_device_take_bus(i2c_device);
+                    if (ret != MR_ERR_OK)
+                    {
+                        return ret;
+                    }
+                    tf_size = mr_i2c_device_transfer(i2c_device, request->msgs, request->number);
+                    mr_i2c_device_release_bus(i2c_device);
+
+                    if (request->done != MR_NULL)
+                    {
+                        request->done(request, tf_size);
+                    }
+                    return MR_ERR_OK;
+                }
+
+                /* Queue the request, it is started as soon as the i2c-bus is free */
+                mr_interrupt_disable();
+                mr_list_insert_before(&i2c_bus->queue, &request->list);
+                mr_interrupt_enable();
+                mr_i2c_bus_start_request(i2c_bus);
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_I2C_TRANSFER:
+        {
+            if (args)
+            {
+                struct mr_i2c_transfer *tf = (struct mr_i2c_transfer *)args;
+                mr_ssize_t tf_size = 0;
+                mr_err_t ret = MR_ERR_OK;
+
+                /* Messages can only be transferred by the host */
+                if (i2c_device->config.host_slave != MR_I2C_HOST)
+                {
+                    return MR_ERR_UNSUPPORTED;
+                }
+
+                /* Take the i2c-bus */
+                ret = mr_i2c_device_take_bus(i2c_device);
+                if (ret != MR_ERR_OK)
+                {
+                    return ret;
+                }
+
+                tf_size = mr_i2c_device_transfer(i2c_device, tf->msgs, tf->number);
+
+                /* Release i2c-bus */
+                mr_i2c_device_release_bus(i2c_device);
+
+                return (mr_err_t)tf_size;
+            }
+            return MR_ERR_INVALID;
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
@@ -250,32 +586,26 @@ static mr_ssize_t mr_i2c_device_read(mr_device_t device, mr_off_t pos, void *buf
 
     if (i2c_device->config.host_slave == MR_I2C_HOST)
     {
-        /* Send position */
-        if (pos >= 0)
+        mr_uint8_t pos_buffer[sizeof(mr_uint32_t)];
+        struct mr_i2c_msg msgs[2];
+        mr_ssize_t ret_size = 0;
+
+        /* Write the position, then read with a repeated start */
+        msgs[0].flags = MR_I2C_M_WR;
+        msgs[0].buffer = pos_buffer;
+        msgs[0].size = (pos >= 0) ? mr_i2c_device_fill_pos(i2c_device, pos, pos_buffer) : 0;
+        msgs[1].flags = MR_I2C_M_RD;
+        msgs[1].buffer = read_buffer;
+        msgs[1].size = size;
+
+        if (msgs[0].size != 0)
         {
-            mr_size_t bits = 0;
-
-            /* Start and send the write command */
-            mr_i2c_device_send_address(i2c_device, MR_I2C_WR);
-
-            while ((bits += 8) <= i2c_device->config.pos_bits)
-            {
-                i2c_bus->ops->write(i2c_bus, (mr_uint8_t)pos);
-                pos >>= 8;
-            }
-        }
-
-        /* Start and send the read command */
-        mr_i2c_device_send_address(i2c_device, MR_I2C_RD);
-
-        while ((read_size += sizeof(*read_buffer)) <= size)
+            ret_size = mr_i2c_device_transfer(i2c_device, msgs, 2);
+        } else
         {
-            *read_buffer = i2c_bus->ops->read(i2c_bus, (mr_state_t)(read_size != size));
-            read_buffer++;
+            ret_size = mr_i2c_device_transfer(i2c_device, &msgs[1], 1);
         }
-
-        /* Stop read */
-        i2c_bus->ops->stop(i2c_bus);
+        read_size = (ret_size < 0) ? 0 : size;
     } else
     {
         if (mr_rb_get_buffer_size(&i2c_device->rx_fifo) == 0)
@@ -316,36 +646,34 @@ static mr_ssize_t mr_i2c_device_write(mr_device_t device, mr_off_t pos, const vo
 
     if (i2c_device->config.host_slave == MR_I2C_HOST)
     {
-        /* Start and send the write command */
-        mr_i2c_device_send_address(i2c_device, MR_I2C_WR);
-
-        /* Send position */
-        if (pos >= 0)
+        mr_uint8_t pos_buffer[sizeof(mr_uint32_t)];
+        struct mr_i2c_msg msgs[2];
+        mr_ssize_t ret_size = 0;
+
+        /* Write the position and the data in one message sequence */
+        msgs[0].flags = MR_I2C_M_WR;
+        msgs[0].buffer = pos_buffer;
+        msgs[0].size = (pos >= 0) ? mr_i2c_device_fill_pos(i2c_device, pos, pos_buffer) : 0;
+        msgs[1].flags = MR_I2C_M_WR | MR_I2C_M_NO_START;
+        msgs[1].buffer = write_buffer;
+        msgs[1].size = size;
+
+        ret_size = mr_i2c_device_transfer(i2c_device, msgs, 2);
+        write_size = (ret_size < 0) ? 0 : size;
+    } else
+    {
+        if (mr_rb_get_buffer_size(&i2c_device->tx_fifo) == 0)
         {
-            mr_size_t bits = 0;
-
-            while ((bits += 8) <= i2c_device->config.pos_bits)
+            /* Blocking write */
+            while ((write_size += sizeof(*write_buffer)) <= size)
             {
-                i2c_bus->ops->write(i2c_bus, (mr_uint8_t)pos);
-                pos >>= 8;
+                i2c_bus->ops->write(i2c_bus, *write_buffer);
+                write_buffer++;
             }
-        }
-
-        while ((write_size += sizeof(*write_buffer)) <= size)
-        {
-            i2c_bus->ops->write(i2c_bus, *write_buffer);
-            write_buffer++;
-        }
-
-        /* Stop write */
-        i2c_bus->ops->stop(i2c_bus);
-    } else
-    {
-        /* Blocking write */
-        while ((write_size += sizeof(*write_buffer)) <= size)
+        } else
         {
-            i2c_bus->ops->write(i2c_bus, *write_buffer);
-            write_buffer++;
+            /* Non-blocking write, the data is sent when the host reads */
+            write_size = mr_rb_write(&i2c_device->tx_fifo, write_buffer, size);
         }
     }
 
@@ -371,7 +699,7 @@ mr_err_t mr_i2c_device_add(mr_i2c_device_t i2c_device, const char *name, mr_uint
     static struct mr_device_ops device_ops =
         {
             mr_i2c_device_open,
-            MR_NULL,
+            mr_i2c_device_close,
             mr_i2c_device_ioctl,
             mr_i2c_device_read,
             mr_i2c_device_write,
@@ -387,10 +715,14 @@ mr_err_t mr_i2c_device_add(mr_i2c_device_t i2c_device, const char *name, mr_uint
     mr_rb_init(&i2c_device->tx_fifo, MR_NULL, 0);
     i2c_device->address = address;
     i2c_device->bus = MR_NULL;
+    i2c_device->reg_map.buffer = MR_NULL;
+    i2c_device->reg_map.size = 0;
+    i2c_device->reg_pos = 0;
+    i2c_device->slave_count = 0;
 
     /* Allocate fifo using configuration size */
     mr_rb_allocate_buffer(&i2c_device->rx_fifo, MR_CFG_I2C_RX_BUFSZ);
-    mr_rb_allocate_buffer(&i2c_device->rx_fifo, MR_CFG_I2C_TX_BUFSZ);
+    mr_rb_allocate_buffer(&i2c_device->tx_fifo, MR_CFG_I2C_TX_BUFSZ);
 
     /* Add the device */
     return mr_device_add(&i2c_device->device, name, Mr_Device_Type_I2C, MR_DEVICE_OFLAG_RDWR, &device_ops, MR_NULL);
@@ -441,6 +773,8 @@ mr_err_t mr_i2c_bus_add(mr_i2c_bus_t i2c_bus, const char *name, struct mr_i2c_bu
     i2c_bus->config = default_config;
     mr_mutex_init(&i2c_bus->lock);
     i2c_bus->owner = MR_NULL;
+    mr_list_init(&i2c_bus->queue);
+    i2c_bus->request = MR_NULL;
 
     /* Protect every operation of the i2c-bus device */
     ops->configure = ops->configure ? ops->configure : err_io_i2c_configure;
@@ -454,6 +788,146 @@ mr_err_t mr_i2c_bus_add(mr_i2c_bus_t i2c_bus, const char *name, struct mr_i2c_bu
     return mr_device_add(&i2c_bus->device, name, Mr_Device_Type_I2CBUS, MR_DEVICE_OFLAG_BUS, &device_ops, data);
 }
 
+/**
+ * @brief This function service interrupt routine of the i2c bus device.
+ *
+ * @param i2c_bus The i2c bus device.
+ * @param event The interrupt event.
+ *
+ * @note The slave driver reports MR_I2C_BUS_EVENT_ADDR_INT (with MR_I2C_M_RD when the host reads) on address match,
+ *       MR_I2C_BUS_EVENT_RX_INT when a byte is received, MR_I2C_BUS_EVENT_TX_INT when a byte must be loaded and
+ *       MR_I2C_BUS_EVENT_STOP_INT on the stop condition.
+ *       The host driver reports MR_I2C_BUS_EVENT_XFER_DONE or MR_I2C_BUS_EVENT_XFER_ERR when start_xfer finishes.
+ */
+void mr_i2c_bus_isr(mr_i2c_bus_t i2c_bus, mr_uint32_t event)
+{
+    mr_i2c_device_t i2c_device = MR_NULL;
+
+    MR_ASSERT(i2c_bus != MR_NULL);
+
+    switch (event & MR_I2C_BUS_EVENT_MASK)
+    {
+        case MR_I2C_BUS_EVENT_XFER_DONE:
+        case MR_I2C_BUS_EVENT_XFER_ERR:
+        {
+            mr_i2c_request_t request = i2c_bus->request;
+            mr_ssize_t result = MR_ERR_IO;
+
+            if (request == MR_NULL)
+            {
+                return;
+            }
+
+            if ((event & MR_I2C_BUS_EVENT_MASK) == MR_I2C_BUS_EVENT_XFER_DONE)
+            {
+                result = (mr_ssize_t)request->number;
+            }
+
+            /* Start the next request back-to-back, then complete the current one */
+            i2c_bus->request = MR_NULL;
+            mr_i2c_device_release_bus(request->i2c_device);
+            if (request->done != MR_NULL)
+            {
+                request->done(request, result);
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    /* Only the slave device that monopolizes the bus is served */
+    i2c_device = (mr_i2c_device_t)mr_mutex_get_owner(&i2c_bus->lock);
+    if (i2c_device == MR_NULL || i2c_device->config.host_slave != MR_I2C_SLAVE)
+    {
+        return;
+    }
+
+    switch (event & MR_I2C_BUS_EVENT_MASK)
+    {
+        case MR_I2C_BUS_EVENT_ADDR_INT:
+        {
+            /* A write restarts the register position, a read continues from it */
+            if ((event & MR_I2C_M_RD) == 0)
+            {
+                i2c_device->reg_pos = 0;
+                i2c_device->slave_count = 0;
+            }
+            break;
+        }
+
+        case MR_I2C_BUS_EVENT_RX_INT:
+        {
+            mr_uint8_t data = i2c_bus->ops->read(i2c_bus, MR_ENABLE);
+            mr_size_t pos_size = i2c_device->config.pos_bits >> 3;
+
+            if (i2c_device->reg_map.size == 0)
+            {
+                /* Save data to the fifo */
+                if (mr_rb_get_buffer_size(&i2c_device->rx_fifo) != 0)
+                {
+                    mr_rb_push_force(&i2c_device->rx_fifo, data);
+                }
+            } else if (i2c_device->slave_count < pos_size)
+            {
+                /* The first bytes are the register position */
+                i2c_device->reg_pos |= (mr_size_t)data << (i2c_device->slave_count << 3);
+            } else
+            {
+                /* Save data to the register map with auto-increment */
+                ((mr_uint8_t *)i2c_device->reg_map.buffer)[i2c_device->reg_pos % i2c_device->reg_map.size] = data;
+                i2c_device->reg_pos++;
+            }
+            i2c_device->slave_count++;
+            break;
+        }
+
+        case MR_I2C_BUS_EVENT_TX_INT:
+        {
+            mr_uint8_t data = 0xff;
+
+            if (i2c_device->reg_map.size == 0)
+            {
+                /* Get data from the fifo, send 0xff if it is empty */
+                mr_rb_pop(&i2c_device->tx_fifo, &data);
+            } else
+            {
+                /* Get data from the register map with auto-increment */
+                data = ((mr_uint8_t *)i2c_device->reg_map.buffer)[i2c_device->reg_pos % i2c_device->reg_map.size];
+                i2c_device->reg_pos++;
+            }
+            i2c_bus->ops->write(i2c_bus, data);
+            break;
+        }
+
+        case MR_I2C_BUS_EVENT_STOP_INT:
+        {
+            mr_size_t pos_size = i2c_device->config.pos_bits >> 3;
+            mr_size_t size = 0;
+
+            if (i2c_device->reg_map.size == 0)
+            {
+                size = (i2c_device->slave_count != 0) ? mr_rb_get_data_size(&i2c_device->rx_fifo) : 0;
+            } else
+            {
+                size = (i2c_device->slave_count > pos_size) ? (i2c_device->slave_count - pos_size) : 0;
+            }
+            i2c_device->slave_count = 0;
+
+            /* Call the receiving completion function once per write transaction */
+            if (size != 0 && i2c_device->device.rx_cb != MR_NULL)
+            {
+                i2c_device->device.rx_cb(&i2c_device->device, &size);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
 static mr_err_t err_io_soft_i2c_bus_configure(mr_soft_i2c_bus_t i2c_bus, mr_state_t state)
 {
     return MR_ERR_IO;
@@ -474,27 +948,33 @@ static mr_level_t err_io_soft_i2c_sda_read(mr_soft_i2c_bus_t i2c_bus)
     return 0;
 }
 
-static mr_state_t mr_soft_i2c_bus_wait_ack(mr_soft_i2c_bus_t soft_i2c_bus)
+MR_INLINE void mr_soft_i2c_bus_delay(mr_soft_i2c_bus_t soft_i2c_bus)
+{
+    /* The GPIO operation is slower than the half-bit, no delay */
+    if (soft_i2c_bus->delay != 0)
+    {
+        mr_delay_tick(soft_i2c_bus->delay);
+    }
+}
+
+static mr_level_t mr_soft_i2c_bus_wait_ack(mr_soft_i2c_bus_t soft_i2c_bus)
 {
     mr_level_t ack = 0;
 
-    soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
+    /* Release sda so the receiver can pull it low */
+    soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_HIGH);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
-    mr_delay_us(soft_i2c_bus->delay);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
 
     ack = soft_i2c_bus->ops->sda_read(soft_i2c_bus);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
 
-    return (mr_state_t)ack;
+    return ack;
 }
 
 static void mr_soft_i2c_bus_send_ack(mr_soft_i2c_bus_t soft_i2c_bus, mr_state_t ack)
 {
-    soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
-
     if (ack)
     {
         soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_LOW);
@@ -503,21 +983,28 @@ static void mr_soft_i2c_bus_send_ack(mr_soft_i2c_bus_t soft_i2c_bus, mr_state_t
         soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_HIGH);
     }
 
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
-    mr_delay_us(soft_i2c_bus->delay);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
 }
 
 static mr_err_t mr_soft_i2c_bus_configure(mr_i2c_bus_t i2c_bus, struct mr_i2c_config *config)
 {
     mr_soft_i2c_bus_t soft_i2c_bus = (mr_soft_i2c_bus_t)i2c_bus;
     mr_state_t state = MR_DISABLE;
+    mr_uint32_t half_bit = 0;
 
     if (config->baud_rate != 0)
     {
         state = MR_ENABLE;
-        soft_i2c_bus->delay = 1000000u / config->baud_rate;
+
+        /* Half-bit time(ns), minus the time taken by the GPIO operation */
+        half_bit = 500000000u / config->baud_rate;
+        half_bit = (half_bit > MR_CFG_SOFT_I2C_IO_NS) ? (half_bit - MR_CFG_SOFT_I2C_IO_NS) : 0;
+
+        /* Convert once here, the bit loop only waits */
+        soft_i2c_bus->delay = mr_delay_ns_to_tick(half_bit);
     }
 
     return soft_i2c_bus->ops->configure(soft_i2c_bus, state);
@@ -527,12 +1014,13 @@ static void mr_soft_i2c_bus_start(mr_i2c_bus_t i2c_bus)
 {
     mr_soft_i2c_bus_t soft_i2c_bus = (mr_soft_i2c_bus_t)i2c_bus;
 
-    soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
+    /* Also used as the repeated start, sda must be released before scl */
     soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_HIGH);
+    soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
 
-    mr_delay_us(soft_i2c_bus->delay);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
 }
 
@@ -540,16 +1028,16 @@ static void mr_soft_i2c_bus_stop(mr_i2c_bus_t i2c_bus)
 {
     mr_soft_i2c_bus_t soft_i2c_bus = (mr_soft_i2c_bus_t)i2c_bus;
 
-    soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_LOW);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
+    soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_LOW);
 
-    mr_delay_us(soft_i2c_bus->delay);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
-    mr_delay_us(soft_i2c_bus->delay);
+    mr_soft_i2c_bus_delay(soft_i2c_bus);
     soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_HIGH);
 }
 
-static void mr_soft_i2c_bus_write(mr_i2c_bus_t i2c_bus, mr_uint8_t data)
+static mr_err_t mr_soft_i2c_bus_write(mr_i2c_bus_t i2c_bus, mr_uint8_t data)
 {
     mr_soft_i2c_bus_t soft_i2c_bus = (mr_soft_i2c_bus_t)i2c_bus;
     mr_size_t bits = 0;
@@ -565,13 +1053,18 @@ static void mr_soft_i2c_bus_write(mr_i2c_bus_t i2c_bus, mr_uint8_t data)
         }
         data = data << 1;
 
-        mr_delay_us(soft_i2c_bus->delay);
+        mr_soft_i2c_bus_delay(soft_i2c_bus);
         soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
-        mr_delay_us(soft_i2c_bus->delay);
+        mr_soft_i2c_bus_delay(soft_i2c_bus);
         soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
     }
 
-    mr_soft_i2c_bus_wait_ack(soft_i2c_bus);
+    /* The ack is low level */
+    if (mr_soft_i2c_bus_wait_ack(soft_i2c_bus) != MR_LOW)
+    {
+        return MR_ERR_IO;
+    }
+    return MR_ERR_OK;
 }
 
 static mr_uint8_t mr_soft_i2c_bus_read(mr_i2c_bus_t i2c_bus, mr_state_t ack)
@@ -580,26 +1073,22 @@ static mr_uint8_t mr_soft_i2c_bus_read(mr_i2c_bus_t i2c_bus, mr_state_t ack)
     mr_uint8_t data = 0;
     mr_size_t bits = 0;
 
-    soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
+    /* Release sda so the transmitter can drive it */
     soft_i2c_bus->ops->sda_write(soft_i2c_bus, MR_HIGH);
 
     for (bits = 0; bits < 8; bits++)
     {
-        mr_delay_us(soft_i2c_bus->delay);
-        soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-        mr_delay_us(soft_i2c_bus->delay);
+        mr_soft_i2c_bus_delay(soft_i2c_bus);
         soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_HIGH);
-        mr_delay_us(soft_i2c_bus->delay);
+        mr_soft_i2c_bus_delay(soft_i2c_bus);
         data = data << 1;
         if (soft_i2c_bus->ops->sda_read(soft_i2c_bus) == MR_HIGH)
         {
             data |= 1;
         }
+        soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
     }
 
-    soft_i2c_bus->ops->scl_write(soft_i2c_bus, MR_LOW);
-    mr_delay_us(soft_i2c_bus->delay);
     mr_soft_i2c_bus_send_ack(soft_i2c_bus, ack);
 
     return data;
@@ -624,6 +1113,8 @@ mr_err_t mr_soft_i2c_bus_add(mr_soft_i2c_bus_t i2c_bus, const char *name, struct
             mr_soft_i2c_bus_stop,
             mr_soft_i2c_bus_write,
             mr_soft_i2c_bus_read,
+            MR_NULL,
+            MR_NULL,
         };
 
     MR_ASSERT(i2c_bus != MR_NULL);
@@ -38,10 +38,38 @@ extern "C" {
 #define MR_I2C_POS_BITS_16              16
 #define MR_I2C_POS_BITS_32              32
 
+/**
+ * @def I2C device baud rate
+ */
+#define MR_I2C_BAUD_RATE_STANDARD       100000
+#define MR_I2C_BAUD_RATE_FAST           400000
+#define MR_I2C_BAUD_RATE_FAST_PLUS      1000000
+
+/**
+ * @def I2C device message flags
+ */
+#define MR_I2C_M_WR                     0x0000
+#define MR_I2C_M_RD                     0x0001
+#define MR_I2C_M_NO_START               0x0002
+#define MR_I2C_M_IGNORE_NAK             0x0004
+#define MR_I2C_M_ADDR_10BIT             0x0008
+
+/**
+ * @def I2C device control transfer flag
+ */
+#define MR_DEVICE_CTRL_I2C_TRANSFER     0x01000000
+#define MR_DEVICE_CTRL_I2C_SET_REG_MAP  0x02000000
+#define MR_DEVICE_CTRL_I2C_SUBMIT       0x03000000
+
 /**
  * @def I2C device interrupt event
  */
 #define MR_I2C_BUS_EVENT_RX_INT         0x10000000
+#define MR_I2C_BUS_EVENT_ADDR_INT       0x20000000
+#define MR_I2C_BUS_EVENT_TX_INT         0x30000000
+#define MR_I2C_BUS_EVENT_STOP_INT       0x40000000
+#define MR_I2C_BUS_EVENT_XFER_DONE      0x50000000
+#define MR_I2C_BUS_EVENT_XFER_ERR       0x60000000
 #define MR_I2C_BUS_EVENT_MASK           0xf0000000
 
 /**
@@ -68,6 +96,38 @@ struct mr_i2c_config
 };
 typedef struct mr_i2c_config *mr_i2c_config_t;
 
+/**
+ * @struct I2C device message
+ */
+struct mr_i2c_msg
+{
+    mr_uint16_t flags;
+    void *buffer;
+
+    mr_size_t size;
+};
+typedef struct mr_i2c_msg *mr_i2c_msg_t;
+
+/**
+ * @struct I2C device transfer
+ */
+struct mr_i2c_transfer
+{
+    struct mr_i2c_msg *msgs;
+
+    mr_size_t number;
+};
+
+/**
+ * @struct I2C device register map
+ */
+struct mr_i2c_reg_map
+{
+    void *buffer;
+
+    mr_size_t size;
+};
+
 typedef struct mr_i2c_bus *mr_i2c_bus_t;
 
 /**
@@ -82,9 +142,28 @@ struct mr_i2c_device
     struct mr_rb tx_fifo;
     mr_uint32_t address;
     mr_i2c_bus_t bus;
+
+    struct mr_i2c_reg_map reg_map;
+    mr_size_t reg_pos;
+    mr_size_t slave_count;
 };
 typedef struct mr_i2c_device *mr_i2c_device_t;
 
+/**
+ * @struct I2C device asynchronous request
+ */
+struct mr_i2c_request
+{
+    struct mr_list list;
+    mr_i2c_device_t i2c_device;
+
+    struct mr_i2c_msg *msgs;
+    mr_size_t number;
+    void (*done)(struct mr_i2c_request *request, mr_ssize_t result);
+    void *user_data;
+};
+typedef struct mr_i2c_request *mr_i2c_request_t;
+
 /**
  * @struct I2C bus operations
  */
@@ -93,8 +172,14 @@ struct mr_i2c_bus_ops
     mr_err_t (*configure)(mr_i2c_bus_t i2c_bus, mr_i2c_config_t config);
     void (*start)(mr_i2c_bus_t i2c_bus);
     void (*stop)(mr_i2c_bus_t i2c_bus);
-    void (*write)(mr_i2c_bus_t i2c_bus, mr_uint8_t data);
+    mr_err_t (*write)(mr_i2c_bus_t i2c_bus, mr_uint8_t data);
     mr_uint8_t (*read)(mr_i2c_bus_t i2c_bus, mr_state_t ack);
+
+    /* Block transfer operations, the address and its bits are taken from the device */
+    mr_ssize_t (*xfer)(mr_i2c_bus_t i2c_bus, mr_i2c_device_t i2c_device, mr_i2c_msg_t msgs, mr_size_t number);
+
+    /* Asynchronous transfer operations */
+    mr_err_t (*start_xfer)(mr_i2c_bus_t i2c_bus, mr_i2c_device_t i2c_device, mr_i2c_msg_t msgs, mr_size_t number);
 };
 
 /**
@@ -107,6 +192,8 @@ struct mr_i2c_bus
     struct mr_i2c_config config;
     struct mr_mutex lock;
     mr_i2c_device_t owner;
+    struct mr_list queue;
+    mr_i2c_request_t request;
 
     const struct mr_i2c_bus_ops *ops;
 };
@@ -131,7 +218,7 @@ struct mr_soft_i2c_bus
 {
     struct mr_i2c_bus i2c_bus;
 
-    mr_size_t delay;
+    mr_uint32_t delay;
 
     const struct mr_soft_i2c_ops *ops;
 };
@@ -148,6 +235,7 @@ mr_err_t mr_i2c_device_add(mr_i2c_device_t i2c_device, const char *name, mr_uint
  * @{
  */
 mr_err_t mr_i2c_bus_add(mr_i2c_bus_t i2c_bus, const char *name, struct mr_i2c_bus_ops *ops, void *data);
+void mr_i2c_bus_isr(mr_i2c_bus_t i2c_bus, mr_uint32_t event);
 /** @} */
 
 /**
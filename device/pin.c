@@ -27,6 +27,66 @@ static void err_io_pin_write(mr_pin_t pin, mr_off_t number, mr_level_t level)
 
 }
 
+static mr_err_t mr_pin_set_irq_cb(mr_pin_t pin, mr_pin_irq_cb_t irq_cb)
+{
+    mr_pin_irq_cb_t slot = MR_NULL;
+
+    if (irq_cb->number < 0)
+    {
+        return MR_ERR_INVALID;
+    }
+    slot = &pin->irq_cb[irq_cb->number % MR_CFG_PIN_IRQ_CB_NUM];
+
+    /* One pin per interrupt line */
+    if (irq_cb->cb != MR_NULL && slot->cb != MR_NULL && slot->number != irq_cb->number)
+    {
+        return MR_ERR_BUSY;
+    }
+    if (irq_cb->cb == MR_NULL && slot->number != irq_cb->number)
+    {
+        return MR_ERR_OK;
+    }
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    *slot = *irq_cb;
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    return MR_ERR_OK;
+}
+
+static mr_ssize_t mr_pin_port_read(mr_pin_t pin, mr_off_t port, mr_uint32_t *buffer, mr_size_t size)
+{
+    mr_size_t read_size = 0;
+
+    /* One call per port value */
+    for (read_size = 0; read_size + sizeof(*buffer) <= size; read_size += sizeof(*buffer))
+    {
+        *buffer = pin->ops->port_read(pin, port);
+        buffer++;
+    }
+
+    return (mr_ssize_t)read_size;
+}
+
+static mr_ssize_t mr_pin_port_write(mr_pin_t pin, mr_off_t port, const mr_uint32_t *buffer, mr_size_t size)
+{
+    mr_uint32_t mask = pin->port.mask;
+    mr_size_t write_size = 0;
+
+    /* Only the masked pins follow the value, one call per port value */
+    for (write_size = 0; write_size + sizeof(*buffer) <= size; write_size += sizeof(*buffer))
+    {
+        pin->ops->port_write_masked(pin, port, *buffer & mask, ~*buffer & mask);
+        buffer++;
+    }
+
+    return (mr_ssize_t)write_size;
+}
+
 static mr_err_t mr_pin_ioctl(mr_device_t device, int cmd, void *args)
 {
     mr_pin_t pin = (mr_pin_t)device;
@@ -49,6 +109,62 @@ static mr_err_t mr_pin_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_OK;
         }
 
+        case MR_DEVICE_CTRL_PIN_SET_IRQ_CB:
+        {
+            if (args)
+            {
+                return mr_pin_set_irq_cb(pin, (mr_pin_irq_cb_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_PIN_SET_PORT:
+        {
+            if (args)
+            {
+                mr_pin_port_t port = (mr_pin_port_t)args;
+
+                if (port->enable == MR_ENABLE && pin->ops->port_read == MR_NULL)
+                {
+                    return MR_ERR_UNSUPPORTED;
+                }
+                pin->port = *port;
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_PIN_GET_PORT:
+        {
+            if (args)
+            {
+                mr_pin_port_t port = (mr_pin_port_t)args;
+                *port = pin->port;
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_PIN_WRITE_PORT:
+        {
+            if (args)
+            {
+                mr_pin_port_write_t port_write = (mr_pin_port_write_t)args;
+
+                if (pin->ops->port_write_masked == MR_NULL)
+                {
+                    return MR_ERR_UNSUPPORTED;
+                }
+                if (port_write->port < 0)
+                {
+                    return MR_ERR_INVALID;
+                }
+                pin->ops->port_write_masked(pin, port_write->port, port_write->set, port_write->clear);
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
@@ -65,6 +181,11 @@ static mr_ssize_t mr_pin_read(mr_device_t device, mr_off_t pos, void *buffer, mr
         return MR_ERR_INVALID;
     }
 
+    if (pin->port.enable == MR_ENABLE)
+    {
+        return mr_pin_port_read(pin, pos, (mr_uint32_t *)buffer, size);
+    }
+
     while ((read_size += sizeof(*read_buffer)) <= size)
     {
         *read_buffer = pin->ops->read(pin, pos);
@@ -85,6 +206,11 @@ static mr_ssize_t mr_pin_write(mr_device_t device, mr_off_t pos, const void *buf
         return MR_ERR_INVALID;
     }
 
+    if (pin->port.enable == MR_ENABLE)
+    {
+        return mr_pin_port_write(pin, pos, (const mr_uint32_t *)buffer, size);
+    }
+
     while ((write_size += sizeof(*write_buffer)) <= size)
     {
         pin->ops->write(pin, pos, *write_buffer);
@@ -114,15 +240,33 @@ mr_err_t mr_pin_device_add(mr_pin_t pin, const char *name, struct mr_pin_ops *op
             mr_pin_read,
             mr_pin_write,
         };
+    struct mr_pin_port default_port = MR_PIN_PORT_DEFAULT;
+    mr_size_t count = 0;
 
     MR_ASSERT(pin != MR_NULL);
     MR_ASSERT(name != MR_NULL);
     MR_ASSERT(ops != MR_NULL);
 
+    /* Initialize the private fields */
+    pin->port = default_port;
+    for (count = 0; count < MR_CFG_PIN_IRQ_CB_NUM; count++)
+    {
+        pin->irq_cb[count].number = -1;
+        pin->irq_cb[count].cb = MR_NULL;
+        pin->irq_cb[count].args = MR_NULL;
+    }
+
     /* Protect every operation of the pin device */
     ops->configure = ops->configure ? ops->configure : err_io_pin_configure;
     ops->write = ops->write ? ops->write : err_io_pin_write;
     ops->read = ops->read ? ops->read : err_io_pin_read;
+
+    /* Port access requires all of its operations */
+    if (ops->port_read == MR_NULL || ops->port_write_masked == MR_NULL)
+    {
+        ops->port_read = MR_NULL;
+        ops->port_write_masked = MR_NULL;
+    }
     pin->ops = ops;
 
     /* Add the device */
@@ -134,11 +278,28 @@ mr_err_t mr_pin_device_add(mr_pin_t pin, const char *name, struct mr_pin_ops *op
  *
  * @param pin The pin device.
  * @param number The number of the interrupt.
+ *
+ * @note The callback of the pin is called if set, otherwise the receiving callback with the number.
  */
 void mr_pin_device_isr(mr_pin_t pin, mr_off_t number)
 {
+    mr_pin_irq_cb_t irq_cb = MR_NULL;
+
     MR_ASSERT(pin != MR_NULL);
 
+    if (number < 0)
+    {
+        return;
+    }
+
+    /* Call the callback of the pin */
+    irq_cb = &pin->irq_cb[number % MR_CFG_PIN_IRQ_CB_NUM];
+    if (irq_cb->cb != MR_NULL && irq_cb->number == number)
+    {
+        irq_cb->cb(&pin->device, irq_cb->args);
+        return;
+    }
+
     /* Call the receiving completion function */
     if (pin->device.rx_cb != MR_NULL)
     {
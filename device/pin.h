@@ -38,6 +38,24 @@ extern "C" {
 #define MR_PIN_MODE_IRQ_LOW             9
 #define MR_PIN_MODE_IRQ_HIGH            10
 
+/**
+ * @def Pin device control command
+ */
+#define MR_DEVICE_CTRL_PIN_SET_PORT     0x01000000                  /* Set port access */
+#define MR_DEVICE_CTRL_PIN_GET_PORT     0x02000000                  /* Get port access */
+#define MR_DEVICE_CTRL_PIN_WRITE_PORT   0x03000000                  /* Set and clear pins of a port */
+#define MR_DEVICE_CTRL_PIN_SET_IRQ_CB   0x04000000                  /* Set the interrupt callback of a pin */
+
+/**
+ * @def Pin device default port access
+ */
+#define MR_PIN_PORT_DEFAULT             \
+{                                       \
+    MR_DISABLE,                         \
+    0,                                  \
+    0xffffffff,                         \
+}
+
 /**
  * @struct Pin device config
  */
@@ -48,6 +66,39 @@ struct mr_pin_config
 };
 typedef struct mr_pin_config *mr_pin_config_t;
 
+/**
+ * @struct Pin device port access
+ */
+struct mr_pin_port
+{
+    mr_uint32_t enable: 1;                                          /* Position is the port, data is the port value */
+    mr_uint32_t reserved: 31;
+    mr_uint32_t mask;                                               /* Pins changed by a port write */
+};
+typedef struct mr_pin_port *mr_pin_port_t;
+
+/**
+ * @struct Pin device port write
+ */
+struct mr_pin_port_write
+{
+    mr_off_t port;
+    mr_uint32_t set;                                                /* Pins to be set */
+    mr_uint32_t clear;                                              /* Pins to be cleared (set wins) */
+};
+typedef struct mr_pin_port_write *mr_pin_port_write_t;
+
+/**
+ * @struct Pin device interrupt callback
+ */
+struct mr_pin_irq_cb
+{
+    mr_off_t number;
+    mr_err_t (*cb)(mr_device_t device, void *args);                 /* Callback, MR_NULL to remove */
+    void *args;                                                     /* Callback args */
+};
+typedef struct mr_pin_irq_cb *mr_pin_irq_cb_t;
+
 typedef struct mr_pin *mr_pin_t;
 
 /**
@@ -58,6 +109,10 @@ struct mr_pin_ops
     mr_err_t (*configure)(mr_pin_t pin, mr_pin_config_t config);
     mr_level_t (*read)(mr_pin_t pin, mr_off_t number);
     void (*write)(mr_pin_t pin, mr_off_t number, mr_level_t level);
+
+    /* Port operations */
+    mr_uint32_t (*port_read)(mr_pin_t pin, mr_off_t port);
+    void (*port_write_masked)(mr_pin_t pin, mr_off_t port, mr_uint32_t set, mr_uint32_t clear);
 };
 
 /**
@@ -67,6 +122,9 @@ struct mr_pin
 {
     struct mr_device device;
 
+    struct mr_pin_port port;
+    struct mr_pin_irq_cb irq_cb[MR_CFG_PIN_IRQ_CB_NUM];
+
     const struct mr_pin_ops *ops;
 };
 
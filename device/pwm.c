@@ -27,6 +27,112 @@ static mr_uint32_t err_io_pwm_read(mr_pwm_t pwm, mr_off_t channel)
     return 0;
 }
 
+static void err_io_pwm_stop_burst(mr_pwm_t pwm)
+{
+
+}
+
+static mr_uint32_t err_io_pwm_get_period(mr_pwm_t pwm)
+{
+    return 0;
+}
+
+static mr_bool_t mr_pwm_is_burst(mr_pwm_t pwm, mr_uint32_t mask)
+{
+    return (pwm->burst.count != 0 && (mask & (1u << pwm->burst.channel)) != 0) ? MR_TRUE : MR_FALSE;
+}
+
+static mr_err_t mr_pwm_stop_burst(mr_pwm_t pwm)
+{
+    if (pwm->burst.count != 0)
+    {
+        pwm->ops->stop_burst(pwm);
+        pwm->burst.count = 0;
+    }
+
+    return MR_ERR_OK;
+}
+
+static mr_err_t mr_pwm_start_burst(mr_pwm_t pwm, mr_pwm_burst_t burst)
+{
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Check if the burst is supported */
+    if (pwm->ops->start_burst == MR_NULL)
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    if (burst->buffer == MR_NULL || burst->count == 0 || burst->channel >= 32
+        || (pwm->config.channel._mask & (1u << burst->channel)) == 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* The last compare is only latched as the burst is done, it must be the 0 that leaves the line low */
+    if (burst->buffer[burst->count - 1] != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* One burst is in progress at a time */
+    if (pwm->burst.count != 0)
+    {
+        return MR_ERR_BUSY;
+    }
+
+    pwm->burst = *burst;
+    ret = pwm->ops->start_burst(pwm, &pwm->burst);
+    if (ret != MR_ERR_OK)
+    {
+        pwm->burst.count = 0;
+    }
+
+    return ret;
+}
+
+static mr_err_t mr_pwm_write_multi(mr_pwm_t pwm, mr_pwm_duty_t duty)
+{
+    mr_uint32_t mask = duty->channel._mask;
+    mr_size_t count = 0, i = 0;
+
+    /* Only the enabled channels can be written */
+    if (mask == 0 || duty->duty == MR_NULL || (mask & ~pwm->config.channel._mask) != 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* The burst channel belongs to the dma */
+    if (mr_pwm_is_burst(pwm, mask) == MR_TRUE)
+    {
+        return MR_ERR_BUSY;
+    }
+
+    /* The driver latches all channels on the same period boundary */
+    if (pwm->ops->write_multi != MR_NULL)
+    {
+        pwm->ops->write_multi(pwm, mask, duty->duty);
+        return MR_ERR_OK;
+    }
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    for (i = 0; i < 32; i++)
+    {
+        if (mask & (1u << i))
+        {
+            pwm->ops->write(pwm, (mr_off_t)i, duty->duty[count]);
+            count++;
+        }
+    }
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    return MR_ERR_OK;
+}
+
 static mr_err_t mr_pwm_open(mr_device_t device)
 {
     mr_pwm_t pwm = (mr_pwm_t)device;
@@ -39,6 +145,8 @@ static mr_err_t mr_pwm_close(mr_device_t device)
     mr_pwm_t pwm = (mr_pwm_t)device;
     struct mr_pwm_config config = {0};
 
+    mr_pwm_stop_burst(pwm);
+
     return pwm->ops->configure(pwm, &config);
 }
 
@@ -54,6 +162,17 @@ static mr_err_t mr_pwm_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_pwm_config_t config = (mr_pwm_config_t)args;
+
+                /* The period is fixed while bursting */
+                if (pwm->burst.count != 0)
+                {
+                    return MR_ERR_BUSY;
+                }
+                if (config->trigger_point > MR_PWM_DUTY_MAX || config->brk > MR_PWM_BREAK_HIGH)
+                {
+                    return MR_ERR_INVALID;
+                }
+
                 ret = pwm->ops->configure(pwm, config);
                 if (ret == MR_ERR_OK)
                 {
@@ -75,6 +194,46 @@ static mr_err_t mr_pwm_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_INVALID;
         }
 
+        case MR_DEVICE_CTRL_PWM_WRITE_MULTI:
+        {
+            if (args)
+            {
+                return mr_pwm_write_multi(pwm, (mr_pwm_duty_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_SET_TX_CB:
+        {
+            device->tx_cb = (mr_device_cb_t)args;
+            return MR_ERR_OK;
+        }
+
+        case MR_DEVICE_CTRL_PWM_START_BURST:
+        {
+            if (args)
+            {
+                return mr_pwm_start_burst(pwm, (mr_pwm_burst_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_PWM_STOP_BURST:
+        {
+            return mr_pwm_stop_burst(pwm);
+        }
+
+        case MR_DEVICE_CTRL_PWM_GET_PERIOD:
+        {
+            if (args)
+            {
+                mr_uint32_t *period = (mr_uint32_t *)args;
+                *period = pwm->ops->get_period(pwm);
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
@@ -111,6 +270,12 @@ static mr_err_t mr_pwm_write(mr_device_t device, mr_off_t pos, const void *buffe
         return MR_ERR_INVALID;
     }
 
+    /* The burst channel belongs to the dma */
+    if (pos < 32 && mr_pwm_is_burst(pwm, 1u << pos) == MR_TRUE)
+    {
+        return MR_ERR_BUSY;
+    }
+
     while ((write_size += sizeof(*write_buffer)) <= size)
     {
         pwm->ops->write(pwm, pos, *write_buffer);
@@ -148,15 +313,108 @@ mr_err_t mr_pwm_device_add(mr_pwm_t pwm, const char *name, struct mr_pwm_ops *op
 
     /* Initialize the private fields */
     pwm->config = default_config;
+    pwm->burst.channel = 0;
+    pwm->burst.buffer = MR_NULL;
+    pwm->burst.count = 0;
 
     /* Protect every operation of the pwm device */
     ops->configure = ops->configure ? ops->configure : err_io_pwm_configure;
     ops->write = ops->write ? ops->write : err_io_pwm_write;
     ops->read = ops->read ? ops->read : err_io_pwm_read;
+
+    /* Burst requires all of its operations */
+    if (ops->stop_burst == MR_NULL || ops->get_period == MR_NULL)
+    {
+        ops->start_burst = MR_NULL;
+    }
+    ops->stop_burst = ops->stop_burst ? ops->stop_burst : err_io_pwm_stop_burst;
+    ops->get_period = ops->get_period ? ops->get_period : err_io_pwm_get_period;
     pwm->ops = ops;
 
     /* Add the device */
     return mr_device_add(&pwm->device, name, Mr_Device_Type_PWM, MR_DEVICE_OFLAG_RDWR, &device_ops, data);
 }
 
+/**
+ * @brief This function service interrupt routine of the pwm device.
+ *
+ * @param pwm The pwm device.
+ * @param event The interrupt event.
+ */
+void mr_pwm_device_isr(mr_pwm_t pwm, mr_uint32_t event)
+{
+    struct mr_pwm_burst burst;
+
+    MR_ASSERT(pwm != MR_NULL);
+
+    switch (event & MR_PWM_EVENT_MASK)
+    {
+        case MR_PWM_EVENT_BURST_DONE:
+        {
+            if (pwm->burst.count == 0)
+            {
+                break;
+            }
+
+            /* The channel is released before the callback, it may start the next burst */
+            burst = pwm->burst;
+            mr_pwm_stop_burst(pwm);
+
+            /* Call the sending completion function */
+            if (pwm->device.tx_cb != MR_NULL)
+            {
+                pwm->device.tx_cb(&pwm->device, &burst);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief This function encodes rgb pixels into ws2812 compares.
+ *
+ * @param buffer The compare buffer, it holds num * MR_PWM_WS2812_BITS + 1 compares.
+ * @param pixels The pixels, 3 bytes (red, green, blue) per pixel.
+ * @param num The number of the pixels.
+ * @param code0 The compare of a 0 bit.
+ * @param code1 The compare of a 1 bit.
+ *
+ * @return The number of the compares.
+ *
+ * @note The bits are sent green, red, blue and msb first, a trailing 0 compare holds the line low after the burst.
+ */
+mr_size_t mr_pwm_ws2812_encode(mr_uint16_t *buffer,
+                               const mr_uint8_t *pixels,
+                               mr_size_t num,
+                               mr_uint16_t code0,
+                               mr_uint16_t code1)
+{
+    mr_uint16_t *output = buffer;
+    mr_uint32_t grb = 0;
+    mr_uint16_t diff = code1 - code0;
+    mr_size_t i = 0, bit = 0;
+
+    MR_ASSERT(buffer != MR_NULL);
+    MR_ASSERT(pixels != MR_NULL || num == 0);
+
+    for (i = 0; i < num; i++)
+    {
+        grb = ((mr_uint32_t)pixels[1] << 16) | ((mr_uint32_t)pixels[0] << 8) | pixels[2];
+        pixels += 3;
+
+        /* Branchless, each bit selects code0 or code1 */
+        for (bit = 0; bit < MR_PWM_WS2812_BITS; bit++)
+        {
+            output[bit] = code0 + (mr_uint16_t)(((grb >> (MR_PWM_WS2812_BITS - 1 - bit)) & 1) * diff);
+        }
+        output += MR_PWM_WS2812_BITS;
+    }
+    *output = 0;
+
+    return num * MR_PWM_WS2812_BITS + 1;
+}
+
 #endif
@@ -25,6 +25,53 @@ extern "C" {
 #define MR_PWM_MODE_NORMAL              0
 #define MR_PWM_MODE_COMPLEMENTARY       1
 
+/**
+ * @def PWM device counter alignment
+ */
+#define MR_PWM_ALIGN_EDGE               0
+#define MR_PWM_ALIGN_CENTER             1
+
+/**
+ * @def PWM device break input
+ */
+#define MR_PWM_BREAK_NONE               0
+#define MR_PWM_BREAK_LOW                1                           /* Outputs off while the input is low */
+#define MR_PWM_BREAK_HIGH               2                           /* Outputs off while the input is high */
+
+/**
+ * @def PWM device trigger output
+ */
+#define MR_PWM_TRIGGER_NONE             0
+#define MR_PWM_TRIGGER_POINT            1                           /* Fires at the trigger point of each period */
+
+/**
+ * @def PWM device duty of 100%
+ */
+#define MR_PWM_DUTY_MAX                 1000000
+
+/**
+ * @def PWM device control write multi-channel flag
+ */
+#define MR_DEVICE_CTRL_PWM_WRITE_MULTI  0x01000000
+
+/**
+ * @def PWM device control burst flag
+ */
+#define MR_DEVICE_CTRL_PWM_START_BURST  0x02000000
+#define MR_DEVICE_CTRL_PWM_STOP_BURST   0x03000000
+#define MR_DEVICE_CTRL_PWM_GET_PERIOD   0x04000000
+
+/**
+ * @def PWM device interrupt event
+ */
+#define MR_PWM_EVENT_BURST_DONE         0x10000000
+#define MR_PWM_EVENT_MASK               0xf0000000
+
+/**
+ * @def PWM device ws2812 encoding
+ */
+#define MR_PWM_WS2812_BITS              24                          /* Periods per pixel */
+
 /**
  * @def PWM device default config
  */
@@ -34,6 +81,10 @@ extern "C" {
     MR_PWM_MODE_NORMAL,                 \
     0,                                  \
     {0},                                \
+    0,                                  \
+    MR_PWM_ALIGN_EDGE,                  \
+    MR_PWM_BREAK_NONE,                  \
+    MR_PWM_TRIGGER_NONE,                \
 }
 
 /**
@@ -43,11 +94,39 @@ struct mr_pwm_config
 {
     mr_uint32_t freq;
     mr_uint32_t mode: 1;
-    mr_uint32_t dead_time: 31;
+    mr_uint32_t dead_time: 31;                                      /* Dead time (ns) */
     struct mr_device_channel channel;
+    mr_uint32_t trigger_point;                                      /* Trigger point (duty of the counter) */
+    mr_uint32_t align: 1;
+    mr_uint32_t brk: 2;
+    mr_uint32_t trigger: 1;
+    mr_uint32_t reserved: 28;
 };
 typedef struct mr_pwm_config *mr_pwm_config_t;
 
+/**
+ * @struct PWM device multi-channel duty
+ */
+struct mr_pwm_duty
+{
+    struct mr_device_channel channel;                               /* Channels to be written */
+    const mr_uint32_t *duty;                                        /* Duties in ascending channel order */
+};
+typedef struct mr_pwm_duty *mr_pwm_duty_t;
+
+/**
+ * @struct PWM device burst
+ *
+ * @note The last compare must be 0, it is latched as the burst is done and holds the line low afterwards.
+ */
+struct mr_pwm_burst
+{
+    mr_uint32_t channel;                                            /* Channel */
+    const mr_uint16_t *buffer;                                      /* Compares, one per period */
+    mr_size_t count;                                                /* Periods */
+};
+typedef struct mr_pwm_burst *mr_pwm_burst_t;
+
 typedef struct mr_pwm *mr_pwm_t;
 
 /**
@@ -58,6 +137,14 @@ struct mr_pwm_ops
     mr_err_t (*configure)(mr_pwm_t pwm, mr_pwm_config_t config);
     void (*write)(mr_pwm_t pwm, mr_off_t channel, mr_uint32_t duty);
     mr_uint32_t (*read)(mr_pwm_t pwm, mr_off_t channel);
+
+    /* Multi-channel operations */
+    void (*write_multi)(mr_pwm_t pwm, mr_uint32_t mask, const mr_uint32_t *duty);
+
+    /* Burst operations */
+    mr_err_t (*start_burst)(mr_pwm_t pwm, mr_pwm_burst_t burst);
+    void (*stop_burst)(mr_pwm_t pwm);
+    mr_uint32_t (*get_period)(mr_pwm_t pwm);
 };
 
 /**
@@ -68,11 +155,23 @@ struct mr_pwm
     struct mr_device device;
 
     struct mr_pwm_config config;
+    struct mr_pwm_burst burst;
 
     const struct mr_pwm_ops *ops;
 };
 
+/**
+ * @addtogroup PWM device
+ * @{
+ */
 mr_err_t mr_pwm_device_add(mr_pwm_t pwm, const char *name, struct mr_pwm_ops *ops, void *data);
+void mr_pwm_device_isr(mr_pwm_t pwm, mr_uint32_t event);
+mr_size_t mr_pwm_ws2812_encode(mr_uint16_t *buffer,
+                               const mr_uint8_t *pixels,
+                               mr_size_t num,
+                               mr_uint16_t code0,
+                               mr_uint16_t code1);
+/** @} */
 
 #endif
 
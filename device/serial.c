@@ -37,15 +37,243 @@ static void err_io_serial_stop_tx(mr_serial_t serial)
 
 }
 
+static void err_io_serial_stop_rx_dma(mr_serial_t serial)
+{
+
+}
+
+static mr_size_t err_io_serial_get_rx_dma_count(mr_serial_t serial)
+{
+    return 0;
+}
+
+static mr_size_t err_io_serial_tx_fifo_space(mr_serial_t serial)
+{
+    return 0;
+}
+
+static void err_io_serial_stop_tx_dma(mr_serial_t serial)
+{
+
+}
+
+static void mr_serial_rx_notify(mr_serial_t serial, mr_bool_t timeout)
+{
+    mr_size_t size = mr_rb_get_data_size(&serial->rx_fifo);
+
+    if (serial->device.rx_cb == MR_NULL || size == 0)
+    {
+        return;
+    }
+
+    /* Below the watermark, only a full fifo or the timeout (quiet line) calls back */
+    if (timeout == MR_FALSE && size < serial->rx_watermark && mr_rb_get_space_size(&serial->rx_fifo) != 0)
+    {
+        return;
+    }
+
+    /* Call the receiving completion function */
+    serial->device.rx_cb(&serial->device, &size);
+}
+
+static mr_err_t mr_serial_configure(mr_serial_t serial, mr_serial_config_t config)
+{
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Check if the line control is supported */
+    if ((config->flow_control == MR_SERIAL_FLOW_CONTROL_RTS_CTS && serial->ops->set_rts == MR_NULL)
+        || (config->mode == MR_SERIAL_MODE_RS485 && serial->ops->set_de == MR_NULL))
+    {
+        return MR_ERR_UNSUPPORTED;
+    }
+
+    ret = serial->ops->configure(serial, config);
+    if (ret != MR_ERR_OK)
+    {
+        return ret;
+    }
+
+    /* Ready to receive, the fifo throttles the sender */
+    if (config->flow_control == MR_SERIAL_FLOW_CONTROL_RTS_CTS)
+    {
+        serial->ops->set_rts(serial, MR_ENABLE);
+        serial->rx_rts = MR_ENABLE;
+    }
+
+    /* The transceiver listens until something is sent */
+    if (config->mode == MR_SERIAL_MODE_RS485 || serial->config.mode == MR_SERIAL_MODE_RS485)
+    {
+        serial->ops->set_de(serial, MR_DISABLE);
+    }
+
+    return MR_ERR_OK;
+}
+
+static void mr_serial_update_rts(mr_serial_t serial)
+{
+    mr_size_t bufsz = mr_rb_get_buffer_size(&serial->rx_fifo);
+    mr_size_t size = mr_rb_get_data_size(&serial->rx_fifo);
+
+    if (serial->config.flow_control != MR_SERIAL_FLOW_CONTROL_RTS_CTS || bufsz == 0)
+    {
+        return;
+    }
+
+    /* Stop the sender at 3/4 of the fifo, resume once it is drained below 1/4 */
+    if (serial->rx_rts == MR_ENABLE && size >= bufsz - bufsz / 4)
+    {
+        serial->ops->set_rts(serial, MR_DISABLE);
+        serial->rx_rts = MR_DISABLE;
+    } else if (serial->rx_rts == MR_DISABLE && size <= bufsz / 4)
+    {
+        serial->ops->set_rts(serial, MR_ENABLE);
+        serial->rx_rts = MR_ENABLE;
+    }
+}
+
+static void mr_serial_start_de(mr_serial_t serial)
+{
+    /* Drive the bus before the first bit, released by the transmission complete */
+    if (serial->config.mode == MR_SERIAL_MODE_RS485)
+    {
+        serial->ops->set_de(serial, MR_ENABLE);
+    }
+}
+
+static mr_err_t mr_serial_set_rx_dma(mr_serial_t serial, mr_state_t state)
+{
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Stop the dma, the fifo restarts from the beginning */
+    if (serial->rx_dma == MR_ENABLE)
+    {
+        serial->ops->stop_rx_dma(serial);
+        serial->rx_dma = MR_DISABLE;
+        mr_rb_reset(&serial->rx_fifo);
+    }
+
+    /* Check if the dma receive is supported */
+    if (state == MR_DISABLE
+        || serial->ops->start_rx_dma == MR_NULL
+        || mr_rb_get_buffer_size(&serial->rx_fifo) == 0)
+    {
+        return MR_ERR_OK;
+    }
+
+    /* Circular receive into the fifo */
+    ret = serial->ops->start_rx_dma(serial, serial->rx_fifo.buffer, mr_rb_get_buffer_size(&serial->rx_fifo));
+    if (ret == MR_ERR_OK)
+    {
+        serial->rx_dma = MR_ENABLE;
+    } else if (ret == MR_ERR_UNSUPPORTED)
+    {
+        /* No dma for this serial, keep the interrupt receive */
+        ret = MR_ERR_OK;
+    }
+
+    return ret;
+}
+
+static mr_size_t mr_serial_sync_rx_dma(mr_serial_t serial)
+{
+    mr_size_t bufsz = mr_rb_get_buffer_size(&serial->rx_fifo);
+    mr_size_t count = 0;
+
+    /* The dma counter is the number of bytes remaining before the end of the fifo */
+    count = serial->ops->get_rx_dma_count(serial);
+    if (count > bufsz)
+    {
+        count = bufsz;
+    }
+
+    return mr_rb_update_write_index(&serial->rx_fifo, bufsz - count);
+}
+
+static void mr_serial_start_tx_dma(mr_serial_t serial)
+{
+    mr_uint8_t *data = MR_NULL;
+    mr_size_t size = 0;
+
+    /* Only one dma block is in progress at a time */
+    if (serial->tx_dma_size != 0 || serial->tx_buffer != MR_NULL)
+    {
+        return;
+    }
+
+    /* Send the linear data directly from the fifo */
+    size = mr_rb_get_linear_data(&serial->tx_fifo, &data);
+    if (size == 0)
+    {
+        return;
+    }
+
+    serial->tx_dma_size = size;
+    if (serial->ops->start_tx_dma(serial, data, size) != MR_ERR_OK)
+    {
+        serial->tx_dma_size = 0;
+    }
+}
+
+static mr_err_t mr_serial_send_buffer(mr_serial_t serial, mr_serial_buffer_t tx_buffer)
+{
+    mr_err_t ret = MR_ERR_OK;
+
+    if (tx_buffer->size == 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    /* The buffer is sent after the fifo, one buffer at a time */
+    if (serial->tx_buffer != MR_NULL || serial->tx_dma_size != 0 || mr_rb_get_data_size(&serial->tx_fifo) != 0)
+    {
+        /* Enable interrupt */
+        mr_interrupt_enable();
+        return MR_ERR_BUSY;
+    }
+    serial->tx_buffer = tx_buffer;
+    serial->tx_count = 0;
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    mr_serial_start_de(serial);
+
+    if (serial->ops->start_tx_dma != MR_NULL)
+    {
+        /* Send directly from the caller buffer by dma */
+        ret = serial->ops->start_tx_dma(serial, tx_buffer->buffer, tx_buffer->size);
+        if (ret != MR_ERR_OK)
+        {
+            serial->tx_buffer = MR_NULL;
+        }
+        return ret;
+    }
+
+    /* Start interrupt send */
+    serial->ops->start_tx(serial);
+    return MR_ERR_OK;
+}
+
 static mr_err_t mr_serial_open(mr_device_t device)
 {
     mr_serial_t serial = (mr_serial_t)device;
+    mr_err_t ret = MR_ERR_OK;
 
     /* Reset fifo */
     mr_rb_reset(&serial->rx_fifo);
     mr_rb_reset(&serial->tx_fifo);
 
-    return serial->ops->configure(serial, &serial->config);
+    ret = mr_serial_configure(serial, &serial->config);
+    if (ret != MR_ERR_OK)
+    {
+        return ret;
+    }
+
+    /* Receive by dma, if supported */
+    return mr_serial_set_rx_dma(serial, MR_ENABLE);
 }
 
 static mr_err_t mr_serial_close(mr_device_t device)
@@ -53,6 +281,22 @@ static mr_err_t mr_serial_close(mr_device_t device)
     mr_serial_t serial = (mr_serial_t)device;
     struct mr_serial_config config = {0};
 
+    mr_serial_set_rx_dma(serial, MR_DISABLE);
+
+    /* Stop the dma send, the fifo is reset on open */
+    if (serial->tx_dma_size != 0 || (serial->tx_buffer != MR_NULL && serial->ops->start_tx_dma != MR_NULL))
+    {
+        serial->ops->stop_tx_dma(serial);
+        serial->tx_dma_size = 0;
+    }
+    serial->tx_buffer = MR_NULL;
+
+    /* Release the bus */
+    if (serial->config.mode == MR_SERIAL_MODE_RS485)
+    {
+        serial->ops->set_de(serial, MR_DISABLE);
+    }
+
     return serial->ops->configure(serial, &config);
 }
 
@@ -68,10 +312,16 @@ static mr_err_t mr_serial_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_serial_config_t config = (mr_serial_config_t)args;
-                ret = serial->ops->configure(serial, config);
+                ret = mr_serial_configure(serial, config);
                 if (ret == MR_ERR_OK)
                 {
                     serial->config = *config;
+
+                    /* The configuration resets the receive mode, restart the dma */
+                    if (serial->rx_dma == MR_ENABLE)
+                    {
+                        ret = mr_serial_set_rx_dma(serial, MR_ENABLE);
+                    }
                 }
                 return ret;
             }
@@ -106,7 +356,16 @@ static mr_err_t mr_serial_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_size_t bufsz = *((mr_size_t *)args);
-                return mr_rb_allocate_buffer(&serial->rx_fifo, bufsz);
+
+                /* The dma must not write to the old fifo */
+                mr_serial_set_rx_dma(serial, MR_DISABLE);
+
+                ret = mr_rb_allocate_buffer(&serial->rx_fifo, bufsz);
+                if (ret != MR_ERR_OK || device->ref_count == 0)
+                {
+                    return ret;
+                }
+                return mr_serial_set_rx_dma(serial, MR_ENABLE);
             }
             return MR_ERR_INVALID;
         }
@@ -121,6 +380,53 @@ static mr_err_t mr_serial_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_INVALID;
         }
 
+        case MR_DEVICE_CTRL_SET_RX_WATERMARK:
+        {
+            if (args)
+            {
+                serial->rx_watermark = *((mr_size_t *)args);
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_SET_RX_TIMEOUT:
+        {
+            if (args)
+            {
+                mr_uint32_t timeout = *((mr_uint32_t *)args);
+
+                /* The timeout is in bit times of quiet line, the driver reports it as the idle event */
+                if (serial->ops->set_rx_timeout == MR_NULL)
+                {
+                    return MR_ERR_UNSUPPORTED;
+                }
+
+                ret = serial->ops->set_rx_timeout(serial, timeout);
+                if (ret == MR_ERR_OK)
+                {
+                    serial->rx_timeout = timeout;
+                }
+                return ret;
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_SERIAL_SET_SEND_CB:
+        {
+            serial->send_cb = (mr_device_cb_t)args;
+            return MR_ERR_OK;
+        }
+
+        case MR_DEVICE_CTRL_SERIAL_SEND:
+        {
+            if (args && (device->sflags & MR_DEVICE_OFLAG_NONBLOCKING))
+            {
+                return mr_serial_send_buffer(serial, (mr_serial_buffer_t)args);
+            }
+            return MR_ERR_INVALID;
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
@@ -142,8 +448,29 @@ static mr_ssize_t mr_serial_read(mr_device_t device, mr_off_t pos, void *buffer,
         }
     } else
     {
+        /* Collect the data received by dma since the last interrupt */
+        if (serial->rx_dma == MR_ENABLE)
+        {
+            /* Disable interrupt */
+            mr_interrupt_disable();
+
+            mr_serial_sync_rx_dma(serial);
+
+            /* Enable interrupt */
+            mr_interrupt_enable();
+        }
+
         /* Non-blocking read */
         read_size = mr_rb_read(&serial->rx_fifo, read_buffer, size);
+
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        /* Let the sender continue once the fifo is drained */
+        mr_serial_update_rts(serial);
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
     }
 
     return (mr_ssize_t)read_size;
@@ -155,21 +482,73 @@ static mr_ssize_t mr_serial_write(mr_device_t device, mr_off_t pos, const void *
     mr_uint8_t *write_buffer = (mr_uint8_t *)buffer;
     mr_size_t write_size = 0;
 
+    if (size == 0)
+    {
+        return 0;
+    }
+
     if (mr_rb_get_buffer_size(&serial->tx_fifo) == 0 || ((device->oflags & MR_DEVICE_OFLAG_NONBLOCKING) == MR_FALSE))
     {
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        /* The transmission complete of a gap between two bytes must not release the de */
+        serial->tx_blocking++;
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
+
+        mr_serial_start_de(serial);
+
         /* Blocking write */
         while ((write_size += sizeof(*write_buffer)) <= size)
         {
+            /* Only a transmission complete after the last byte counts, a gap has been served before this */
+            serial->tx_done = MR_FALSE;
+
             serial->ops->write(serial, *write_buffer);
             write_buffer++;
         }
+
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        /* Release the de now if the last byte has already been sent, otherwise the transmission complete does it */
+        serial->tx_blocking--;
+        if (serial->tx_blocking == 0 && serial->tx_done == MR_TRUE)
+        {
+            serial->tx_done = MR_FALSE;
+            mr_serial_device_isr(serial, MR_SERIAL_EVENT_TX_DONE);
+        }
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
     } else
     {
         /* Non-blocking write */
         write_size = mr_rb_write(&serial->tx_fifo, write_buffer, size);
+        if (write_size == 0)
+        {
+            return 0;
+        }
+
+        mr_serial_start_de(serial);
+
+        if (serial->ops->start_tx_dma != MR_NULL)
+        {
+            /* Disable interrupt */
+            mr_interrupt_disable();
 
-        /* Start interrupt send */
-        serial->ops->start_tx(serial);
+            /* Start dma send */
+            mr_serial_start_tx_dma(serial);
+
+            /* Enable interrupt */
+            mr_interrupt_enable();
+        } else
+        {
+            /* Start interrupt send */
+            serial->ops->start_tx(serial);
+        }
     }
 
     return (mr_ssize_t)write_size;
@@ -206,13 +585,29 @@ mr_err_t mr_serial_device_add(mr_serial_t serial, const char *name, struct mr_se
     serial->config = default_config;
     mr_rb_init(&serial->rx_fifo, MR_NULL, 0);
     mr_rb_init(&serial->tx_fifo, MR_NULL, 0);
+    serial->rx_dma = MR_DISABLE;
+    serial->tx_dma_size = 0;
+    serial->tx_buffer = MR_NULL;
+    serial->tx_count = 0;
+    serial->send_cb = MR_NULL;
+    serial->rx_watermark = 0;
+    serial->rx_timeout = 0;
+    serial->rx_rts = MR_DISABLE;
+    serial->tx_blocking = 0;
+    serial->tx_done = MR_FALSE;
 
     /* Allocate fifo using configuration size */
     mr_rb_allocate_buffer(&serial->rx_fifo, MR_CFG_SERIAL_RX_BUFSZ);
     mr_rb_allocate_buffer(&serial->tx_fifo, MR_CFG_SERIAL_TX_BUFSZ);
 
+    /* Dma send requires all of its operations */
+    if (ops->stop_tx_dma == MR_NULL)
+    {
+        ops->start_tx_dma = MR_NULL;
+    }
+
     /* Non-blocking mode */
-    if (ops->start_tx != MR_NULL && ops->stop_tx != MR_NULL)
+    if ((ops->start_tx != MR_NULL && ops->stop_tx != MR_NULL) || ops->start_tx_dma != MR_NULL)
     {
         support_flag |= MR_DEVICE_OFLAG_NONBLOCKING;
     }
@@ -223,6 +618,22 @@ mr_err_t mr_serial_device_add(mr_serial_t serial, const char *name, struct mr_se
     ops->read = ops->read ? ops->read : err_io_serial_read;
     ops->start_tx = ops->start_tx ? ops->start_tx : err_io_serial_start_tx;
     ops->stop_tx = ops->stop_tx ? ops->stop_tx : err_io_serial_stop_tx;
+
+    /* Dma receive requires all of its operations */
+    if (ops->stop_rx_dma == MR_NULL || ops->get_rx_dma_count == MR_NULL)
+    {
+        ops->start_rx_dma = MR_NULL;
+    }
+    ops->stop_rx_dma = ops->stop_rx_dma ? ops->stop_rx_dma : err_io_serial_stop_rx_dma;
+    ops->get_rx_dma_count = ops->get_rx_dma_count ? ops->get_rx_dma_count : err_io_serial_get_rx_dma_count;
+
+    /* Fifo send requires all of its operations */
+    if (ops->tx_fifo_space == MR_NULL)
+    {
+        ops->write_fifo = MR_NULL;
+    }
+    ops->tx_fifo_space = ops->tx_fifo_space ? ops->tx_fifo_space : err_io_serial_tx_fifo_space;
+    ops->stop_tx_dma = ops->stop_tx_dma ? ops->stop_tx_dma : err_io_serial_stop_tx_dma;
     serial->ops = ops;
 
     /* Add the device */
@@ -246,24 +657,117 @@ void mr_serial_device_isr(mr_serial_t serial, mr_uint32_t event)
             /* Save data to the fifo */
             mr_uint8_t data = serial->ops->read(serial);
             mr_rb_push_force(&serial->rx_fifo, data);
+            mr_serial_update_rts(serial);
+
+            mr_serial_rx_notify(serial, MR_FALSE);
+            break;
+        }
 
-            /* Call the receiving completion function */
-            if (serial->device.rx_cb != MR_NULL)
+        case MR_SERIAL_EVENT_RX_DMA:
+        {
+            /* Check if the serial receives by dma */
+            if (serial->rx_dma != MR_ENABLE)
             {
-                mr_size_t size = mr_rb_get_data_size(&serial->rx_fifo);
-                serial->device.rx_cb(&serial->device, &size);
+                return;
             }
+
+            /* Update the fifo from the dma counter */
+            if (mr_serial_sync_rx_dma(serial) == 0)
+            {
+                return;
+            }
+            mr_serial_update_rts(serial);
+
+            mr_serial_rx_notify(serial, MR_FALSE);
+            break;
+        }
+
+        case MR_SERIAL_EVENT_RX_IDLE:
+        {
+            /* Update the fifo from the dma counter */
+            if (serial->rx_dma == MR_ENABLE)
+            {
+                mr_serial_sync_rx_dma(serial);
+                mr_serial_update_rts(serial);
+            }
+
+            /* The line is quiet, call back once for the whole burst */
+            mr_serial_rx_notify(serial, MR_TRUE);
             break;
         }
 
         case MR_SERIAL_EVENT_TX_INT:
         {
-            /* Write data from the fifo */
-            mr_uint8_t data = 0;
-            if (mr_rb_pop(&serial->tx_fifo, &data) == sizeof(data))
+            mr_size_t send_size = 0;
+
+            if (serial->tx_buffer != MR_NULL)
+            {
+                mr_serial_buffer_t tx_buffer = serial->tx_buffer;
+                const mr_uint8_t *data = (const mr_uint8_t *)tx_buffer->buffer + serial->tx_count;
+                mr_size_t size = tx_buffer->size - serial->tx_count;
+
+                if (size != 0)
+                {
+                    /* Write data from the caller buffer */
+                    if (serial->ops->write_fifo != MR_NULL)
+                    {
+                        send_size = serial->ops->tx_fifo_space(serial);
+                        send_size = (send_size < size) ? send_size : size;
+                        serial->ops->write_fifo(serial, data, send_size);
+                    } else
+                    {
+                        serial->ops->write(serial, *data);
+                        send_size = sizeof(*data);
+                    }
+                    serial->tx_count += send_size;
+                    break;
+                }
+
+                /* Call the buffer sending completion function */
+                serial->tx_buffer = MR_NULL;
+                if (serial->send_cb != MR_NULL)
+                {
+                    serial->send_cb(&serial->device, tx_buffer);
+                }
+
+                /* Continue with the fifo written meanwhile */
+                if (mr_rb_get_data_size(&serial->tx_fifo) == 0)
+                {
+                    serial->ops->stop_tx(serial);
+                }
+                break;
+            }
+
+            if (serial->ops->write_fifo != MR_NULL)
             {
-                serial->ops->write(serial, data);
+                mr_uint8_t buffer[16];
+                mr_size_t space = serial->ops->tx_fifo_space(serial);
+                mr_size_t size = 0;
+
+                /* Fill the hardware fifo as much as it accepts */
+                while (space != 0)
+                {
+                    size = mr_rb_read(&serial->tx_fifo, buffer, (space < sizeof(buffer)) ? space : sizeof(buffer));
+                    if (size == 0)
+                    {
+                        break;
+                    }
+                    serial->ops->write_fifo(serial, buffer, size);
+                    send_size += size;
+                    space -= size;
+                }
             } else
+            {
+                /* Write data from the fifo */
+                mr_uint8_t data = 0;
+                if (mr_rb_pop(&serial->tx_fifo, &data) == sizeof(data))
+                {
+                    serial->ops->write(serial, data);
+                    send_size = sizeof(data);
+                }
+            }
+
+            if (send_size == 0 && mr_rb_get_data_size(&serial->tx_fifo) == 0)
             {
                 /* Stop interrupt send */
                 serial->ops->stop_tx(serial);
@@ -278,6 +782,77 @@ void mr_serial_device_isr(mr_serial_t serial, mr_uint32_t event)
             break;
         }
 
+        case MR_SERIAL_EVENT_TX_DMA:
+        {
+            /* The caller buffer has been sent */
+            if (serial->tx_buffer != MR_NULL)
+            {
+                mr_serial_buffer_t tx_buffer = serial->tx_buffer;
+
+                serial->ops->stop_tx_dma(serial);
+                serial->tx_buffer = MR_NULL;
+
+                /* Call the buffer sending completion function */
+                if (serial->send_cb != MR_NULL)
+                {
+                    serial->send_cb(&serial->device, tx_buffer);
+                }
+
+                /* Continue with the fifo written meanwhile */
+                mr_serial_start_tx_dma(serial);
+                break;
+            }
+
+            /* Check if the serial sends by dma */
+            if (serial->tx_dma_size == 0)
+            {
+                return;
+            }
+
+            /* Release the sent block and continue with the rest of the fifo */
+            mr_rb_discard(&serial->tx_fifo, serial->tx_dma_size);
+            serial->tx_dma_size = 0;
+            mr_serial_start_tx_dma(serial);
+
+            /* Call the sending completion function */
+            if (serial->tx_dma_size == 0)
+            {
+                serial->ops->stop_tx_dma(serial);
+
+                if (serial->device.tx_cb != MR_NULL)
+                {
+                    mr_size_t size = 0;
+                    serial->device.tx_cb(&serial->device, &size);
+                }
+            }
+            break;
+        }
+
+        case MR_SERIAL_EVENT_TX_DONE:
+        {
+            /* Check if the transceiver is driven */
+            if (serial->config.mode != MR_SERIAL_MODE_RS485)
+            {
+                return;
+            }
+
+            /* A blocking write is still in progress, it releases the de after its last byte */
+            if (serial->tx_blocking != 0)
+            {
+                serial->tx_done = MR_TRUE;
+                return;
+            }
+
+            /* The last bit has left the shift register, turn the bus around if nothing is pending */
+            if (serial->tx_buffer == MR_NULL
+                && serial->tx_dma_size == 0
+                && mr_rb_get_data_size(&serial->tx_fifo) == 0)
+            {
+                serial->ops->set_de(serial, MR_DISABLE);
+            }
+            break;
+        }
+
         default:
             break;
     }
@@ -55,13 +55,41 @@ extern "C" {
 #define MR_SERIAL_NRZ_NORMAL            0
 #define MR_SERIAL_NRZ_INVERTED          1
 
+/**
+ * @def Serial device flow control
+ */
+#define MR_SERIAL_FLOW_CONTROL_NONE     0
+#define MR_SERIAL_FLOW_CONTROL_RTS_CTS  1
+
+/**
+ * @def Serial device line mode
+ */
+#define MR_SERIAL_MODE_NORMAL           0
+#define MR_SERIAL_MODE_RS485            1
+
+/**
+ * @def Serial device control send buffer flags
+ */
+#define MR_DEVICE_CTRL_SERIAL_SEND          0x01000000
+#define MR_DEVICE_CTRL_SERIAL_SET_SEND_CB   0x02000000
+
 /**
  * @def Serial device interrupt event
  */
 #define MR_SERIAL_EVENT_RX_INT          0x10000000
 #define MR_SERIAL_EVENT_TX_INT          0x20000000
+#define MR_SERIAL_EVENT_RX_DMA          0x30000000
+#define MR_SERIAL_EVENT_RX_IDLE         0x40000000
+#define MR_SERIAL_EVENT_TX_DMA          0x50000000
+#define MR_SERIAL_EVENT_TX_DONE         0x60000000
 #define MR_SERIAL_EVENT_MASK            0xf0000000
 
+/**
+ * @def Serial device frame bits (start, data, parity and stop), the receive timeout counts in bit times
+ */
+#define MR_SERIAL_FRAME_BITS(config)    \
+    (1 + (config)->data_bits + ((config)->parity != MR_SERIAL_PARITY_NONE) + (config)->stop_bits)
+
 /**
  * @def Serial device default config
  */
@@ -73,6 +101,8 @@ extern "C" {
     MR_SERIAL_PARITY_NONE,              \
     MR_SERIAL_BIT_ORDER_LSB,            \
     MR_SERIAL_NRZ_NORMAL,               \
+    MR_SERIAL_FLOW_CONTROL_NONE,        \
+    MR_SERIAL_MODE_NORMAL,              \
 }
 
 /**
@@ -86,10 +116,23 @@ struct mr_serial_config
     mr_uint32_t parity: 2;
     mr_uint32_t bit_order: 1;
     mr_uint32_t invert: 1;
-    mr_uint32_t reserved: 21;
+    mr_uint32_t flow_control: 1;
+    mr_uint32_t mode: 1;
+    mr_uint32_t reserved: 19;
 };
 typedef struct mr_serial_config *mr_serial_config_t;
 
+/**
+ * @struct Serial device send buffer
+ */
+struct mr_serial_buffer
+{
+    const void *buffer;
+
+    mr_size_t size;
+};
+typedef struct mr_serial_buffer *mr_serial_buffer_t;
+
 typedef struct mr_serial *mr_serial_t;
 
 /**
@@ -104,6 +147,26 @@ struct mr_serial_ops
     /* Interrupt send operations */
     void (*start_tx)(mr_serial_t serial);
     void (*stop_tx)(mr_serial_t serial);
+
+    /* DMA receive operations */
+    mr_err_t (*start_rx_dma)(mr_serial_t serial, void *buffer, mr_size_t size);
+    void (*stop_rx_dma)(mr_serial_t serial);
+    mr_size_t (*get_rx_dma_count)(mr_serial_t serial);
+
+    /* FIFO send operations */
+    mr_size_t (*tx_fifo_space)(mr_serial_t serial);
+    void (*write_fifo)(mr_serial_t serial, const mr_uint8_t *buffer, mr_size_t size);
+
+    /* DMA send operations */
+    mr_err_t (*start_tx_dma)(mr_serial_t serial, const void *buffer, mr_size_t size);
+    void (*stop_tx_dma)(mr_serial_t serial);
+
+    /* Receive timeout operations */
+    mr_err_t (*set_rx_timeout)(mr_serial_t serial, mr_uint32_t timeout);
+
+    /* Line control operations */
+    void (*set_rts)(mr_serial_t serial, mr_state_t state);
+    void (*set_de)(mr_serial_t serial, mr_state_t state);
 };
 
 /**
@@ -116,6 +179,16 @@ struct mr_serial
     struct mr_serial_config config;
     struct mr_rb rx_fifo;
     struct mr_rb tx_fifo;
+    mr_state_t rx_dma;
+    mr_size_t tx_dma_size;
+    mr_serial_buffer_t tx_buffer;
+    mr_size_t tx_count;
+    mr_device_cb_t send_cb;
+    mr_size_t rx_watermark;
+    mr_uint32_t rx_timeout;
+    mr_state_t rx_rts;
+    mr_size_t tx_blocking;
+    mr_bool_t tx_done;
 
     const struct mr_serial_ops *ops;
 };
@@ -45,6 +45,16 @@ static mr_level_t err_io_spi_cs_read(mr_spi_bus_t spi_bus, mr_off_t cs_number)
     return 0;
 }
 
+static void err_io_spi_stop_rx_dma(mr_spi_bus_t spi_bus)
+{
+
+}
+
+static mr_size_t err_io_spi_get_rx_dma_count(mr_spi_bus_t spi_bus)
+{
+    return 0;
+}
+
 mr_err_t mr_spi_device_take_bus(mr_spi_device_t spi_device)
 {
     mr_spi_bus_t spi_bus = (mr_spi_bus_t)spi_device->bus;
@@ -98,6 +108,76 @@ static mr_err_t mr_spi_device_release_bus(mr_spi_device_t spi_device)
     return mr_mutex_release(&spi_bus->lock, spi_device);
 }
 
+MR_INLINE mr_bool_t mr_spi_device_is_rx_dma(mr_spi_device_t spi_device)
+{
+    mr_spi_bus_t spi_bus = spi_device->bus;
+
+    return (mr_bool_t)(spi_bus != MR_NULL
+                       && spi_device->config.host_slave == MR_SPI_SLAVE
+                       && spi_bus->ops->start_rx_dma != MR_NULL
+                       && mr_rb_get_buffer_size(&spi_device->rx_fifo) != 0);
+}
+
+static mr_err_t mr_spi_device_set_rx_dma(mr_spi_device_t spi_device, mr_state_t state)
+{
+    mr_spi_bus_t spi_bus = spi_device->bus;
+
+    /* Check if the dma receive is supported */
+    if (mr_spi_device_is_rx_dma(spi_device) == MR_FALSE)
+    {
+        return MR_ERR_OK;
+    }
+
+    /* Stop the dma, the fifo restarts from the beginning */
+    spi_bus->ops->stop_rx_dma(spi_bus);
+    mr_rb_reset(&spi_device->rx_fifo);
+
+    if (state == MR_ENABLE)
+    {
+        /* Circular receive into the fifo */
+        return spi_bus->ops->start_rx_dma(spi_bus,
+                                          spi_device->rx_fifo.buffer,
+                                          mr_rb_get_buffer_size(&spi_device->rx_fifo));
+    }
+
+    return MR_ERR_OK;
+}
+
+static mr_size_t mr_spi_device_sync_rx_dma(mr_spi_device_t spi_device)
+{
+    mr_spi_bus_t spi_bus = spi_device->bus;
+    mr_size_t bufsz = mr_rb_get_buffer_size(&spi_device->rx_fifo);
+    mr_size_t count = 0;
+
+    /* The dma counter is the number of bytes remaining before the end of the fifo */
+    count = spi_bus->ops->get_rx_dma_count(spi_bus);
+    if (count > bufsz)
+    {
+        count = bufsz;
+    }
+
+    return mr_rb_update_write_index(&spi_device->rx_fifo, bufsz - count);
+}
+
+static void mr_spi_device_rx_notify(mr_spi_device_t spi_device, mr_bool_t timeout)
+{
+    mr_size_t size = mr_rb_get_data_size(&spi_device->rx_fifo);
+
+    if (spi_device->device.rx_cb == MR_NULL || size == 0)
+    {
+        return;
+    }
+
+    /* Below the watermark, only a full fifo or the chip-select release calls back */
+    if (timeout == MR_FALSE && size < spi_device->rx_watermark && mr_rb_get_space_size(&spi_device->rx_fifo) != 0)
+    {
+        return;
+    }
+
+    /* Call the receiving completion function */
+    spi_device->device.rx_cb(&spi_device->device, &size);
+}
+
 static mr_err_t mr_spi_device_connect_bus(mr_spi_device_t spi_device, const char *name)
 {
     mr_device_t spi_bus = MR_NULL;
@@ -121,6 +201,7 @@ static mr_err_t mr_spi_device_connect_bus(mr_spi_device_t spi_device, const char
             /* Release the mutex */
             if (spi_device->config.host_slave == MR_SPI_SLAVE)
             {
+                mr_spi_device_set_rx_dma(spi_device, MR_DISABLE);
                 mr_spi_device_release_bus(spi_device);
             }
 
@@ -150,7 +231,14 @@ static mr_err_t mr_spi_device_connect_bus(mr_spi_device_t spi_device, const char
             }
 
             /* Open the spi-bus */
-            return mr_device_open(spi_bus, MR_DEVICE_OFLAG_BUS);
+            ret = mr_device_open(spi_bus, MR_DEVICE_OFLAG_BUS);
+            if (ret != MR_ERR_OK)
+            {
+                return ret;
+            }
+
+            /* Slave mode receives by dma, if supported */
+            return mr_spi_device_set_rx_dma(spi_device, MR_ENABLE);
         }
     }
 
@@ -325,14 +413,42 @@ static mr_ssize_t mr_spi_device_transfer(mr_spi_device_t spi_device,
     return (mr_ssize_t)tf_size;
 }
 
+#if (MR_CFG_PIN == MR_CFG_ENABLE)
+static mr_err_t mr_spi_device_cs_irq_cb(mr_device_t device, void *args)
+{
+    mr_spi_device_t spi_device = (mr_spi_device_t)args;
+
+    /* The chip-select is released, the burst is over */
+    if (spi_device->bus != MR_NULL)
+    {
+        mr_spi_bus_isr(spi_device->bus, MR_SPI_BUS_EVENT_RX_IDLE);
+    }
+
+    return MR_ERR_OK;
+}
+#endif
+
 static mr_err_t mr_spi_device_configure_cs(mr_spi_device_t spi_device, mr_state_t state)
 {
 #if (MR_CFG_PIN == MR_CFG_ENABLE)
     struct mr_pin_config pin_config;
+    struct mr_pin_irq_cb irq_cb;
     mr_device_t pin = MR_NULL;
+    mr_err_t ret = MR_ERR_OK;
 
     pin_config.number = spi_device->cs_number;
     pin_config.mode = (state == MR_ENABLE) ? MR_PIN_MODE_OUTPUT : MR_PIN_MODE_NONE;
+    irq_cb.number = spi_device->cs_number;
+    irq_cb.cb = MR_NULL;
+    irq_cb.args = spi_device;
+
+    /* The slave is interrupted by the chip-select release, it ends a burst */
+    if (state == MR_ENABLE && spi_device->config.host_slave == MR_SPI_SLAVE)
+    {
+        pin_config.mode = (spi_device->config.cs_active == MR_SPI_CS_ACTIVE_LOW) ? MR_PIN_MODE_IRQ_RISING
+                                                                                  : MR_PIN_MODE_IRQ_FALLING;
+        irq_cb.cb = mr_spi_device_cs_irq_cb;
+    }
 
     /* Configure pin */
     if (spi_device->config.cs_active != MR_SPI_CS_ACTIVE_HARDWARE)
@@ -340,6 +456,11 @@ static mr_err_t mr_spi_device_configure_cs(mr_spi_device_t spi_device, mr_state_
         pin = mr_device_find("pin");
         if (pin != MR_NULL)
         {
+            ret = mr_device_ioctl(pin, MR_DEVICE_CTRL_PIN_SET_IRQ_CB, &irq_cb);
+            if (ret != MR_ERR_OK)
+            {
+                return ret;
+            }
             return mr_device_ioctl(pin, MR_DEVICE_CTRL_SET_CONFIG, &pin_config);
         }
     }
@@ -351,11 +472,19 @@ static mr_err_t mr_spi_device_configure_cs(mr_spi_device_t spi_device, mr_state_
 static mr_err_t mr_spi_device_open(mr_device_t device)
 {
     mr_spi_device_t spi_device = (mr_spi_device_t)device;
+    mr_err_t ret = MR_ERR_OK;
 
     /* Reset fifo */
     mr_rb_reset(&spi_device->rx_fifo);
     mr_rb_reset(&spi_device->tx_fifo);
 
+    /* Restart the dma with the reset fifo */
+    ret = mr_spi_device_set_rx_dma(spi_device, MR_ENABLE);
+    if (ret != MR_ERR_OK)
+    {
+        return ret;
+    }
+
     return mr_spi_device_configure_cs(spi_device, MR_ENABLE);
 }
 
@@ -385,8 +514,8 @@ static mr_err_t mr_spi_device_ioctl(mr_device_t device, int cmd, void *args)
                     {
                         if (config->host_slave == MR_SPI_HOST)
                         {
+                            mr_spi_device_set_rx_dma(spi_device, MR_DISABLE);
                             mr_spi_device_release_bus(spi_device);
-
                         } else
                         {
                             /* Slave mode monopolizes the bus */
@@ -399,6 +528,22 @@ static mr_err_t mr_spi_device_ioctl(mr_device_t device, int cmd, void *args)
                     }
                 }
                 spi_device->config = *config;
+
+                /* The chip-select follows the role of the opened device */
+                if (device->ref_count != 0)
+                {
+                    ret = mr_spi_device_configure_cs(spi_device, MR_ENABLE);
+                    if (ret != MR_ERR_OK)
+                    {
+                        return ret;
+                    }
+                }
+
+                /* Slave mode receives by dma, if supported */
+                if (config->host_slave == MR_SPI_SLAVE)
+                {
+                    return mr_spi_device_set_rx_dma(spi_device, MR_ENABLE);
+                }
                 return MR_ERR_OK;
             }
             return MR_ERR_INVALID;
@@ -421,6 +566,46 @@ static mr_err_t mr_spi_device_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_OK;
         }
 
+        case MR_DEVICE_CTRL_SET_RX_BUFSZ:
+        {
+            if (args)
+            {
+                mr_size_t bufsz = *((mr_size_t *)args);
+                mr_err_t ret = MR_ERR_OK;
+
+                /* The dma must not write to the old fifo */
+                mr_spi_device_set_rx_dma(spi_device, MR_DISABLE);
+
+                ret = mr_rb_allocate_buffer(&spi_device->rx_fifo, bufsz);
+                if (ret != MR_ERR_OK)
+                {
+                    return ret;
+                }
+                return mr_spi_device_set_rx_dma(spi_device, MR_ENABLE);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_SET_TX_BUFSZ:
+        {
+            if (args)
+            {
+                mr_size_t bufsz = *((mr_size_t *)args);
+                return mr_rb_allocate_buffer(&spi_device->tx_fifo, bufsz);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_SET_RX_WATERMARK:
+        {
+            if (args)
+            {
+                spi_device->rx_watermark = *((mr_size_t *)args);
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
         case MR_DEVICE_CTRL_CONNECT:
         {
             return mr_spi_device_connect_bus(spi_device, (const char *)args);
@@ -508,6 +693,18 @@ static mr_ssize_t mr_spi_device_read(mr_device_t device, mr_off_t pos, void *buf
             read_size = mr_spi_device_transfer(spi_device, MR_NULL, read_buffer, size, MR_SPI_RD);
         } else
         {
+            /* Collect the data received by dma since the last interrupt */
+            if (mr_spi_device_is_rx_dma(spi_device) == MR_TRUE)
+            {
+                /* Disable interrupt */
+                mr_interrupt_disable();
+
+                mr_spi_device_sync_rx_dma(spi_device);
+
+                /* Enable interrupt */
+                mr_interrupt_enable();
+            }
+
             /* Non-blocking read */
             read_size = (mr_ssize_t)mr_rb_read(&spi_device->rx_fifo, read_buffer, size);
         }
@@ -592,10 +789,11 @@ mr_err_t mr_spi_device_add(mr_spi_device_t spi_device, const char *name, mr_off_
     mr_rb_init(&spi_device->tx_fifo, MR_NULL, 0);
     spi_device->cs_number = cs_number;
     spi_device->bus = MR_NULL;
+    spi_device->rx_watermark = 0;
 
     /* Allocate fifo using configuration size */
     mr_rb_allocate_buffer(&spi_device->rx_fifo, MR_CFG_SPI_RX_BUFSZ);
-    mr_rb_allocate_buffer(&spi_device->rx_fifo, MR_CFG_SPI_TX_BUFSZ);
+    mr_rb_allocate_buffer(&spi_device->tx_fifo, MR_CFG_SPI_TX_BUFSZ);
 
     /* Add the device */
     return mr_device_add(&spi_device->device, name, Mr_Device_Type_SPI, MR_DEVICE_OFLAG_RDWR, &device_ops, MR_NULL);
@@ -653,6 +851,14 @@ mr_err_t mr_spi_bus_add(mr_spi_bus_t spi_bus, const char *name, struct mr_spi_bu
     ops->read = ops->read ? ops->read : err_io_spi_read;
     ops->cs_write = ops->cs_write ? ops->cs_write : err_io_spi_cs_write;
     ops->cs_read = ops->cs_read ? ops->cs_read : err_io_spi_cs_read;
+
+    /* Slave dma receive requires all of its operations */
+    if (ops->stop_rx_dma == MR_NULL || ops->get_rx_dma_count == MR_NULL)
+    {
+        ops->start_rx_dma = MR_NULL;
+    }
+    ops->stop_rx_dma = ops->stop_rx_dma ? ops->stop_rx_dma : err_io_spi_stop_rx_dma;
+    ops->get_rx_dma_count = ops->get_rx_dma_count ? ops->get_rx_dma_count : err_io_spi_get_rx_dma_count;
     spi_bus->ops = ops;
 
     /* Add the device */
@@ -688,12 +894,44 @@ void mr_spi_bus_isr(mr_spi_bus_t spi_bus, mr_uint32_t event)
                 mr_uint32_t data = spi_bus->ops->read(spi_bus);
                 mr_rb_write_force(&spi_device->rx_fifo, &data, (spi_device->config.data_bits >> 3));
 
-                /* Call the receiving completion function */
-                if (spi_device->device.rx_cb != MR_NULL)
+                mr_spi_device_rx_notify(spi_device, MR_FALSE);
+            }
+            break;
+        }
+
+        case MR_SPI_BUS_EVENT_RX_DMA:
+        {
+            mr_spi_device_t spi_device = (mr_spi_device_t)mr_mutex_get_owner(&spi_bus->lock);
+
+            /* Check if the spi device receives by dma */
+            if (spi_device != MR_NULL && mr_spi_device_is_rx_dma(spi_device) == MR_TRUE)
+            {
+                /* Update the fifo from the dma counter */
+                if (mr_spi_device_sync_rx_dma(spi_device) == 0)
                 {
-                    mr_size_t size = mr_rb_get_data_size(&spi_device->rx_fifo);
-                    spi_device->device.rx_cb(&spi_device->device, &size);
+                    return;
                 }
+
+                mr_spi_device_rx_notify(spi_device, MR_FALSE);
+            }
+            break;
+        }
+
+        case MR_SPI_BUS_EVENT_RX_IDLE:
+        {
+            mr_spi_device_t spi_device = (mr_spi_device_t)mr_mutex_get_owner(&spi_bus->lock);
+
+            /* Check if the spi device is valid */
+            if (spi_device != MR_NULL)
+            {
+                /* Update the fifo from the dma counter */
+                if (mr_spi_device_is_rx_dma(spi_device) == MR_TRUE)
+                {
+                    mr_spi_device_sync_rx_dma(spi_device);
+                }
+
+                /* The chip-select is released, call back once for the whole burst */
+                mr_spi_device_rx_notify(spi_device, MR_TRUE);
             }
             break;
         }
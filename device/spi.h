@@ -69,6 +69,8 @@ extern "C" {
  * @def SPI device interrupt event
  */
 #define MR_SPI_BUS_EVENT_RX_INT         0x10000000
+#define MR_SPI_BUS_EVENT_RX_DMA         0x20000000
+#define MR_SPI_BUS_EVENT_RX_IDLE        0x30000000
 #define MR_SPI_BUS_EVENT_MASK           0xf0000000
 
 /**
@@ -126,6 +128,7 @@ struct mr_spi_device
     struct mr_rb tx_fifo;
     mr_off_t cs_number;
     mr_spi_bus_t bus;
+    mr_size_t rx_watermark;
 };
 typedef struct mr_spi_device *mr_spi_device_t;
 
@@ -139,6 +142,11 @@ struct mr_spi_bus_ops
     mr_uint32_t (*read)(mr_spi_bus_t spi_bus);
     void (*cs_write)(mr_spi_bus_t spi_bus, mr_off_t cs_number, mr_level_t level);
     mr_level_t (*cs_read)(mr_spi_bus_t spi_bus, mr_off_t cs_number);
+
+    /* Slave DMA receive operations */
+    mr_err_t (*start_rx_dma)(mr_spi_bus_t spi_bus, void *buffer, mr_size_t size);
+    void (*stop_rx_dma)(mr_spi_bus_t spi_bus);
+    mr_size_t (*get_rx_dma_count)(mr_spi_bus_t spi_bus);
 };
 
 /**
@@ -12,6 +12,8 @@
 
 #if (MR_CFG_TIMER == MR_CFG_ENABLE)
 
+#define MR_TIMER_SOLVE_STEPS            16
+
 static mr_err_t err_io_timer_configure(mr_timer_t timer, mr_state_t state)
 {
     return MR_ERR_IO;
@@ -32,10 +34,21 @@ static mr_uint32_t err_io_timer_get_count(mr_timer_t timer)
     return 0;
 }
 
-static mr_err_t mr_timer_calculate(mr_timer_t timer, mr_uint32_t timeout, mr_uint32_t *prescaler, mr_uint32_t *period)
+static mr_uint32_t err_io_timer_get_capture(mr_timer_t timer, mr_uint32_t channel)
+{
+    return 0;
+}
+
+static mr_bool_t err_io_timer_get_pending(mr_timer_t timer)
 {
-    mr_uint32_t clk_mhz = 0, temp_period = 0, temp_reload = 0, error = 0, error_min = timeout;
-    mr_uint32_t i = 0;
+    return MR_FALSE;
+}
+
+static mr_err_t mr_timer_calculate(mr_timer_t timer, mr_uint32_t timeout, mr_timer_solution_t solution)
+{
+    mr_uint32_t clk_mhz = 0, prescaler_max = timer->data->prescaler_max, scale = 1, ticks = timeout;
+    mr_uint32_t reload = 0, reload_min = 0, error = 0;
+    mr_size_t i = 0;
 
     /* Check the clock */
     clk_mhz = timer->data->clk / 1000000u;
@@ -44,85 +57,89 @@ static mr_err_t mr_timer_calculate(mr_timer_t timer, mr_uint32_t timeout, mr_uin
         return MR_ERR_GENERIC;
     }
 
-    /* Calculate the prescaler */
-    *prescaler = clk_mhz;
-    for (; *prescaler <= (timer->data->prescaler_max / 10); *prescaler *= 10)
+    /* Input capture keeps the 1us tick, the timestamps are as fine as the counter allows */
+    if (timer->config.capture != MR_TIMER_CAPTURE_NONE)
     {
-        if (timeout % 10 != 0)
+        prescaler_max = clk_mhz;
+    } else
+    {
+        /* Reuse a recent solution */
+        for (i = 0; i < MR_CFG_TIMER_CACHE_SIZE; i++)
         {
-            break;
+            if (timer->cache[i].timeout == timeout)
+            {
+                *solution = timer->cache[i];
+                return MR_ERR_OK;
+            }
         }
-        timeout /= 10;
     }
 
-    /* Calculate the Least error reload */
-    if (timeout <= timer->data->period_max)
+    /* Calculate the prescaler, the coarsest 10^n us tick that divides the timeout */
+    solution->prescaler = clk_mhz;
+    while (solution->prescaler <= (prescaler_max / 10) && (ticks % 10) == 0)
     {
-        temp_period = timeout;
-    } else
-    {
-        temp_period = (timeout / timer->data->period_max);
+        solution->prescaler *= 10;
+        scale *= 10;
+        ticks /= 10;
     }
 
-    for (; temp_period > 0; temp_period--)
+    /* The fewest reloads that fit the period, the next few are tried for an exact split */
+    reload_min = (ticks - 1) / timer->data->period_max + 1;
+    solution->reload = reload_min;
+    solution->period = ticks / reload_min;
+    solution->error = ticks - solution->period * reload_min;
+    for (reload = reload_min + 1;
+         reload < reload_min + MR_TIMER_SOLVE_STEPS && reload <= ticks && solution->error != 0;
+         reload++)
     {
-        temp_reload = timeout / temp_period;
-
-        error = timeout - temp_reload * temp_period;
-        if (error == 0)
+        error = ticks % reload;
+        if (error < solution->error)
         {
-            timer->reload = temp_reload;
-            *period = temp_period;
-            break;
-        }
-        if (error <= error_min)
-        {
-            error_min = error;
-            timer->reload = temp_reload;
-            *period = temp_period;
+            solution->reload = reload;
+            solution->period = ticks / reload;
+            solution->error = error;
         }
     }
+    solution->timeout = timeout;
+    solution->error *= scale;
 
-    /* Calculate the optimal reload */
-    for (i = 2; i <= 9; i++)
+    /* Replace the oldest solution */
+    if (timer->config.capture == MR_TIMER_CAPTURE_NONE)
     {
-        while ((timer->reload % i) == 0)
-        {
-            mr_uint32_t temp = *period * i;
-            if (temp <= timer->data->period_max)
-            {
-                *period = temp;
-                timer->reload /= i;
-            } else
-            {
-                break;
-            }
-            if (timer->reload > *period && timer->reload < timer->data->period_max)
-            {
-                timer->reload = timer->reload ^ *period;
-                *period = timer->reload ^ *period;
-                timer->reload = timer->reload ^ *period;
-            }
-        }
+        timer->cache[timer->cache_index] = *solution;
+        timer->cache_index = (timer->cache_index + 1) % MR_CFG_TIMER_CACHE_SIZE;
     }
 
-    timer->count = *period;
-    timer->timeout = (*prescaler) * (*period) / clk_mhz;
-
     return MR_ERR_OK;
 }
 
 static mr_err_t mr_timer_open(mr_device_t device)
 {
     mr_timer_t timer = (mr_timer_t)device;
+    mr_err_t ret = MR_ERR_OK;
+
+    /* Reset fifo */
+    mr_rb_reset(&timer->rx_fifo);
+    timer->capture_overflow = 0;
+
+    ret = timer->ops->configure(timer, MR_ENABLE);
+    if (ret != MR_ERR_OK || timer->config.capture == MR_TIMER_CAPTURE_NONE)
+    {
+        return ret;
+    }
 
-    return timer->ops->configure(timer, MR_ENABLE);
+    return timer->ops->capture(timer, timer->config.channel, timer->config.capture);
 }
 
 static mr_err_t mr_timer_close(mr_device_t device)
 {
     mr_timer_t timer = (mr_timer_t)device;
 
+    if (timer->config.capture != MR_TIMER_CAPTURE_NONE)
+    {
+        timer->ops->capture(timer, timer->config.channel, MR_TIMER_CAPTURE_NONE);
+    }
+
     return timer->ops->configure(timer, MR_DISABLE);
 }
 
@@ -138,6 +155,30 @@ static mr_err_t mr_timer_ioctl(mr_device_t device, int cmd, void *args)
             if (args)
             {
                 mr_timer_config_t config = (mr_timer_config_t)args;
+
+                /* Check if the input capture is supported */
+                if (config->capture != MR_TIMER_CAPTURE_NONE && timer->ops->capture == MR_NULL)
+                {
+                    return MR_ERR_UNSUPPORTED;
+                }
+
+                /* Move the capture to the new channel and edge */
+                if (device->ref_count != 0)
+                {
+                    if (timer->config.capture != MR_TIMER_CAPTURE_NONE)
+                    {
+                        timer->ops->capture(timer, timer->config.channel, MR_TIMER_CAPTURE_NONE);
+                    }
+                    if (config->capture != MR_TIMER_CAPTURE_NONE)
+                    {
+                        ret = timer->ops->capture(timer, config->channel, config->capture);
+                        if (ret != MR_ERR_OK)
+                        {
+                            timer->config.capture = MR_TIMER_CAPTURE_NONE;
+                            return ret;
+                        }
+                    }
+                }
                 timer->config = *config;
                 return ret;
             }
@@ -161,27 +202,72 @@ static mr_err_t mr_timer_ioctl(mr_device_t device, int cmd, void *args)
             return MR_ERR_OK;
         }
 
+        case MR_DEVICE_CTRL_SET_RX_BUFSZ:
+        {
+            if (args)
+            {
+                mr_size_t bufsz = *((mr_size_t *)args);
+                return mr_rb_allocate_buffer(&timer->rx_fifo, bufsz);
+            }
+            return MR_ERR_INVALID;
+        }
+
+        case MR_DEVICE_CTRL_TIMER_GET_SOLUTION:
+        {
+            if (args)
+            {
+                mr_timer_solution_t solution = (mr_timer_solution_t)args;
+                *solution = timer->solution;
+                return MR_ERR_OK;
+            }
+            return MR_ERR_INVALID;
+        }
+
         default:
             return MR_ERR_UNSUPPORTED;
     }
 }
 
+static mr_uint32_t mr_timer_get_count(mr_timer_t timer)
+{
+    mr_uint32_t count = timer->ops->get_count(timer);
+
+    if (timer->data->count_mode == MR_TIMER_COUNT_MODE_DOWN)
+    {
+        count = timer->count - count;
+    }
+    return count;
+}
+
 static mr_ssize_t mr_timer_read(mr_device_t device, mr_off_t pos, void *buffer, mr_size_t size)
 {
     mr_timer_t timer = (mr_timer_t)device;
     mr_uint32_t *read_buffer = (mr_uint32_t *)buffer;
     mr_size_t read_size = 0;
+    mr_uint32_t overflow = 0, count = 0;
+
+    /* Read the captured timestamps */
+    if (timer->config.capture != MR_TIMER_CAPTURE_NONE)
+    {
+        return (mr_ssize_t)mr_rb_read(&timer->rx_fifo, read_buffer, size - (size % sizeof(*read_buffer)));
+    }
 
-    while ((read_size += sizeof(*read_buffer)) <= size)
+    for (read_size = 0; read_size + sizeof(*read_buffer) <= size; read_size += sizeof(*read_buffer))
     {
-        /* Get current count */
-        mr_uint32_t count = timer->ops->get_count(timer);
-        if (timer->data->count_mode == MR_TIMER_COUNT_MODE_DOWN)
+        /* Get current count, again if the overflow interrupt ran in between */
+        do
         {
-            count = timer->count - count;
-        }
+            overflow = timer->overflow;
+            count = mr_timer_get_count(timer);
+
+            /* The counter wrapped but its interrupt is still pending, count the wrap here */
+            if (timer->ops->get_pending(timer) == MR_TRUE)
+            {
+                count = mr_timer_get_count(timer) + timer->count;
+            }
+        } while (overflow != timer->overflow);
 
-        *read_buffer = timer->overflow * timer->timeout + count * timer->timeout / timer->count;
+        *read_buffer = overflow * timer->timeout + count * timer->timeout / timer->count;
 
         read_buffer++;
     }
@@ -193,11 +279,13 @@ static mr_ssize_t mr_timer_write(mr_device_t device, mr_off_t pos, const void *b
 {
     mr_timer_t timer = (mr_timer_t)device;
     mr_uint32_t *write_buffer = (mr_uint32_t *)buffer;
-    mr_uint32_t timeout = 0, prescaler = 0, period = 0;
+    struct mr_timer_solution solution = {0};
+    mr_uint32_t timeout = 0;
     mr_size_t write_size = 0;
     mr_err_t ret = MR_ERR_OK;
 
-    while ((write_size += sizeof(*write_buffer)) <= size)
+    /* The last timeout of the buffer is taken */
+    for (write_size = 0; write_size + sizeof(*write_buffer) <= size; write_size += sizeof(*write_buffer))
     {
         timeout = *write_buffer;
         write_buffer++;
@@ -207,12 +295,18 @@ static mr_ssize_t mr_timer_write(mr_device_t device, mr_off_t pos, const void *b
     timer->overflow = 0;
     if (timeout != 0)
     {
-        ret = mr_timer_calculate(timer, timeout, &prescaler, &period);
+        ret = mr_timer_calculate(timer, timeout, &solution);
         if (ret != MR_ERR_OK)
         {
             return ret;
         }
-        timer->ops->start(timer, prescaler, period);
+
+        /* The prescaler is a whole number of us per count */
+        timer->reload = solution.reload;
+        timer->count = solution.period;
+        timer->timeout = solution.prescaler / (timer->data->clk / 1000000u) * solution.period;
+        timer->solution = solution;
+        timer->ops->start(timer, solution.prescaler, solution.period);
     }
 
     return (mr_ssize_t)write_size;
@@ -259,13 +353,29 @@ mr_err_t mr_timer_device_add(mr_timer_t timer,
     timer->overflow = 0;
     timer->count = 1;
     timer->timeout = 0;
+    mr_memset(&timer->solution, 0, sizeof(timer->solution));
+    mr_memset(timer->cache, 0, sizeof(timer->cache));
+    timer->cache_index = 0;
+    mr_rb_init(&timer->rx_fifo, MR_NULL, 0);
+    timer->capture_overflow = 0;
     timer->data = timer_data;
 
+    /* Allocate fifo using configuration size */
+    mr_rb_allocate_buffer(&timer->rx_fifo, MR_CFG_TIMER_RX_BUFSZ);
+
     /* Protect every operation of the timer device */
     ops->configure = ops->configure ? ops->configure : err_io_timer_configure;
     ops->start = ops->start ? ops->start : err_io_timer_start;
     ops->stop = ops->stop ? ops->stop : err_io_timer_stop;
     ops->get_count = ops->get_count ? ops->get_count : err_io_timer_get_count;
+
+    /* Input capture requires all of its operations */
+    if (ops->get_capture == MR_NULL)
+    {
+        ops->capture = MR_NULL;
+    }
+    ops->get_capture = ops->get_capture ? ops->get_capture : err_io_timer_get_capture;
+    ops->get_pending = ops->get_pending ? ops->get_pending : err_io_timer_get_pending;
     timer->ops = ops;
 
     /* Add the container */
@@ -287,6 +397,7 @@ void mr_timer_device_isr(mr_timer_t timer, mr_uint32_t event)
         case MR_TIMER_EVENT_PIT_INT:
         {
             timer->overflow++;
+            timer->capture_overflow++;
 
             /* Timeout */
             if (timer->overflow == timer->reload)
@@ -308,6 +419,33 @@ void mr_timer_device_isr(mr_timer_t timer, mr_uint32_t event)
             break;
         }
 
+        case MR_TIMER_EVENT_CAPTURE_INT:
+        {
+            mr_uint32_t channel = event & ~MR_TIMER_EVENT_MASK;
+            mr_uint32_t count = timer->ops->get_capture(timer, channel);
+            mr_uint32_t time = 0;
+
+            /* The latched count since the last overflow, in us */
+            if (timer->data->count_mode == MR_TIMER_COUNT_MODE_DOWN)
+            {
+                count = timer->count - count;
+            }
+            time = timer->capture_overflow * timer->timeout + count * (timer->timeout / timer->count);
+
+            /* Save the timestamp to the fifo, whole timestamps only */
+            if (mr_rb_get_space_size(&timer->rx_fifo) >= sizeof(time))
+            {
+                mr_rb_write(&timer->rx_fifo, &time, sizeof(time));
+            }
+
+            /* Call the receiving completion function */
+            if (timer->device.rx_cb != MR_NULL)
+            {
+                timer->device.rx_cb(&timer->device, &time);
+            }
+            break;
+        }
+
         default:
             break;
     }
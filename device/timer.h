@@ -31,10 +31,24 @@ extern "C" {
 #define MR_TIMER_COUNT_MODE_UP          0
 #define MR_TIMER_COUNT_MODE_DOWN        1
 
+/**
+ * @def Timer device capture edge
+ */
+#define MR_TIMER_CAPTURE_NONE           0
+#define MR_TIMER_CAPTURE_RISING         1
+#define MR_TIMER_CAPTURE_FALLING        2
+#define MR_TIMER_CAPTURE_BOTH           3
+
+/**
+ * @def Timer device control get solution flag
+ */
+#define MR_DEVICE_CTRL_TIMER_GET_SOLUTION   0x01000000
+
 /**
  * @def Timer device interrupt event
  */
 #define MR_TIMER_EVENT_PIT_INT          0x10000000
+#define MR_TIMER_EVENT_CAPTURE_INT      0x20000000
 #define MR_TIMER_EVENT_MASK             0xf0000000
 
 /**
@@ -43,6 +57,8 @@ extern "C" {
 #define MR_TIMER_CONFIG_DEFAULT         \
 {                                       \
     MR_TIMER_MODE_PERIOD,               \
+    MR_TIMER_CAPTURE_NONE,              \
+    1,                                  \
 }
 
 /**
@@ -51,7 +67,9 @@ extern "C" {
 struct mr_timer_config
 {
     mr_uint32_t mode: 1;
-    mr_uint32_t reserved: 31;
+    mr_uint32_t capture: 2;
+    mr_uint32_t channel: 4;
+    mr_uint32_t reserved: 25;
 };
 typedef struct mr_timer_config *mr_timer_config_t;
 
@@ -67,6 +85,19 @@ struct mr_timer_data
     mr_uint32_t reserved: 31;
 };
 
+/**
+ * @struct Timer device solution
+ */
+struct mr_timer_solution
+{
+    mr_uint32_t timeout;
+    mr_uint32_t prescaler;
+    mr_uint32_t period;
+    mr_uint32_t reload;
+    mr_uint32_t error;
+};
+typedef struct mr_timer_solution *mr_timer_solution_t;
+
 typedef struct mr_timer *mr_timer_t;
 
 /**
@@ -78,6 +109,13 @@ struct mr_timer_ops
     void (*start)(mr_timer_t timer, mr_uint32_t prescaler, mr_uint32_t period);
     void (*stop)(mr_timer_t timer);
     mr_uint32_t (*get_count)(mr_timer_t timer);
+
+    /* Input capture operations */
+    mr_err_t (*capture)(mr_timer_t timer, mr_uint32_t channel, mr_uint32_t edge);
+    mr_uint32_t (*get_capture)(mr_timer_t timer, mr_uint32_t channel);
+
+    /* Update operations */
+    mr_bool_t (*get_pending)(mr_timer_t timer);
 };
 
 /**
@@ -89,9 +127,14 @@ struct mr_timer
 
     struct mr_timer_config config;
     mr_uint32_t reload;
-    mr_uint32_t overflow;
+    volatile mr_uint32_t overflow;
     mr_uint32_t count;
     mr_uint32_t timeout;
+    struct mr_timer_solution solution;
+    struct mr_timer_solution cache[MR_CFG_TIMER_CACHE_SIZE];
+    mr_size_t cache_index;
+    struct mr_rb rx_fifo;
+    mr_uint32_t capture_overflow;
 
     struct mr_timer_data *data;
     const struct mr_timer_ops *ops;
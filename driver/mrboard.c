@@ -34,6 +34,11 @@ void mr_interrupt_enable(void)
 
 }
 
+void mr_delay_ns(mr_uint32_t ns)
+{
+
+}
+
 void mr_delay_us(mr_size_t us)
 {
 
@@ -29,6 +29,9 @@ void mr_log_output(mr_base_t level, const char *tag, const char *format, ...);
 void mr_assert_handle(char *file, int line);
 void mr_interrupt_disable(void);
 void mr_interrupt_enable(void);
+void mr_delay_ns(mr_uint32_t ns);
+mr_uint32_t mr_delay_ns_to_tick(mr_uint32_t ns);
+void mr_delay_tick(mr_uint32_t tick);
 void mr_delay_us(mr_uint32_t us);
 void mr_delay_ms(mr_uint32_t ms);
 /** @} */
@@ -49,6 +52,9 @@ mr_size_t mr_rb_push(mr_rb_t rb, mr_uint8_t data);
 mr_size_t mr_rb_push_force(mr_rb_t rb, mr_uint8_t data);
 mr_size_t mr_rb_write(mr_rb_t rb, const void *buffer, mr_size_t size);
 mr_size_t mr_rb_write_force(mr_rb_t rb, const void *buffer, mr_size_t size);
+mr_size_t mr_rb_update_write_index(mr_rb_t rb, mr_size_t index);
+mr_size_t mr_rb_get_linear_data(mr_rb_t rb, mr_uint8_t **data);
+mr_size_t mr_rb_discard(mr_rb_t rb, mr_size_t size);
 /** @} */
 
 /**
@@ -84,6 +90,23 @@ mr_err_t mr_mutex_release(mr_mutex_t mutex, void *owner);
 volatile void *mr_mutex_get_owner(mr_mutex_t mutex);
 /** @} */
 
+/**
+ * @addtogroup Clock
+ * @{
+ */
+void mr_clock_init(mr_clock_t clock,
+                   mr_uint32_t freq,
+                   mr_uint32_t period,
+                   mr_uint32_t (*get_count)(mr_clock_t clock),
+                   void *data);
+void mr_clock_set_default(mr_clock_t clock);
+mr_err_t mr_clock_attach(const char *name, mr_uint32_t period);
+void mr_clock_overflow(mr_clock_t clock);
+mr_uint64_t mr_clock_get_count(mr_clock_t clock);
+mr_uint64_t mr_clock_get_us(void);
+mr_uint64_t mr_clock_get_ns(void);
+/** @} */
+
 /**
  * @addtogroup Memory
  * @{
@@ -79,6 +79,17 @@ extern "C" {
  */
 #define MR_CFG_ADC                      MR_CFG_ENABLE
 
+#if (MR_CFG_ADC == MR_CFG_ENABLE)
+
+/**
+ * @def ADC filter channel number.
+ *
+ * Channels 0 to (number - 1) support oversampling and calibration.
+ */
+#define MR_CFG_ADC_FILTER_NUM           18
+
+#endif
+
 /**
  * @def DAC config.
  *
@@ -105,6 +116,14 @@ extern "C" {
 #define MR_CFG_I2C_RX_BUFSZ             0
 #define MR_CFG_I2C_TX_BUFSZ             0
 
+/**
+ * @def Soft I2C GPIO operation time(ns).
+ *
+ * The time taken by one scl/sda operation, it is deducted from every half-bit delay.
+ * If the GPIO operation is slower than the half-bit, the soft I2C does not delay at all.
+ */
+#define MR_CFG_SOFT_I2C_IO_NS           0
+
 #endif
 
 /**
@@ -128,6 +147,17 @@ extern "C" {
  */
 #define MR_CFG_PIN                      MR_CFG_ENABLE
 
+#if (MR_CFG_PIN == MR_CFG_ENABLE)
+
+/**
+ * @def Pin interrupt callback number.
+ *
+ * Pin numbers equal modulo the number (the interrupt lines) share one callback.
+ */
+#define MR_CFG_PIN_IRQ_CB_NUM           16
+
+#endif
+
 /**
  * @def PWM config.
  *
@@ -184,6 +214,24 @@ extern "C" {
  */
 #define MR_CFG_TIMER                    MR_CFG_ENABLE
 
+#if (MR_CFG_TIMER == MR_CFG_ENABLE)
+
+/**
+ * @def Timer solution cache size.
+ *
+ * Recent timeouts reuse their prescaler and period, at least 1.
+ */
+#define MR_CFG_TIMER_CACHE_SIZE         4
+
+/**
+ * @def Timer capture buffer default size.
+ *
+ * If the default configuration is not required, set the value to 0.
+ */
+#define MR_CFG_TIMER_RX_BUFSZ           0
+
+#endif
+
 #endif
 
 //<------------------------------------ Module config ------------------------------------>
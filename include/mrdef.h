@@ -288,6 +288,22 @@ struct mr_mutex
 };
 typedef struct mr_mutex *mr_mutex_t;                                /* Type for mutex */
 
+typedef struct mr_clock *mr_clock_t;                                /* Type for clock */
+
+/**
+ * @struct Clock
+ */
+struct mr_clock
+{
+    mr_uint32_t freq;                                               /* Counter frequency */
+    mr_uint32_t period;                                             /* Counts per overflow, 0 if free running 32bit */
+    volatile mr_uint32_t overflow;                                  /* Overflow count */
+    mr_uint32_t last;                                               /* Last count of the free running counter */
+
+    mr_uint32_t (*get_count)(mr_clock_t clock);                     /* Get the counter */
+    void *data;                                                     /* Clock data */
+};
+
 /**
  * @addtogroup Device
  * @{
@@ -338,6 +354,8 @@ enum mr_device_type
 #define MR_DEVICE_CTRL_SET_RX_BUFSZ     0x50000000                  /* Set receive buffer size */
 #define MR_DEVICE_CTRL_SET_TX_BUFSZ     0x60000000                  /* Set transmit buffer size */
 #define MR_DEVICE_CTRL_CONNECT          0x70000000                  /* Connect device */
+#define MR_DEVICE_CTRL_SET_RX_WATERMARK 0x80000000                  /* Set receive callback watermark */
+#define MR_DEVICE_CTRL_SET_RX_TIMEOUT   0x90000000                  /* Set receive callback timeout */
 
 typedef struct mr_device *mr_device_t;                              /* Type for device */
 typedef mr_err_t (*mr_device_cb_t)(mr_device_t device, void *args); /* Type for device callback */
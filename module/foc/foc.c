@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2023, mr-library Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2023-11-20     MacRsh       first version
+ */
+
+#include "foc.h"
+
+#if (MR_CFG_FOC == MR_CFG_ENABLE)
+
+#define DEBUG_TAG   "foc"
+
+/* Phases a, b and c are driven by the pwm channels 1, 2 and 3 */
+#define MR_FOC_PWM_CHANNEL_MASK         ((1 << 1) | (1 << 2) | (1 << 3))
+
+static struct mr_list foc_list = {&foc_list, &foc_list};
+
+static mr_int32_t mr_foc_sine_quarter(mr_int32_t x)
+{
+    mr_int32_t x2 = (x * x) >> 15;
+    mr_int32_t y = 0;
+
+    /* Fitted odd 5th order polynomial of sin(x * pi / 2) over a quarter period, exact at both ends (Q15) */
+    y = 20966 - ((x2 * 2295) >> 15);
+    y = 51439 - ((x2 * y) >> 15);
+    y = (x * y) >> 15;
+
+    return (y > 32767) ? 32767 : y;
+}
+
+static mr_int32_t mr_foc_sine(mr_uint16_t angle)
+{
+    mr_int32_t x = (mr_int32_t)(angle & 0x3fff) << 1;
+
+    /* Mirrored into the first quarter */
+    if (angle & 0x4000)
+    {
+        x = 32768 - x;
+    }
+    x = mr_foc_sine_quarter(x);
+
+    return (angle & 0x8000) ? -x : x;
+}
+
+static mr_uint32_t mr_foc_sqrt(mr_uint32_t value)
+{
+    mr_uint32_t root = 0, bit = 1u << 30;
+
+    /* Bitwise integer square root, one result bit per round */
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+static mr_int32_t mr_foc_sample_to_current(mr_foc_t foc, mr_uint16_t sample, mr_size_t phase)
+{
+    mr_int32_t current = (((mr_int32_t)sample - foc->config.offset[phase]) * foc->config.current_gain) >> 12;
+
+    mr_limit_range(current, -(MR_FOC_Q15_ONE - 1), MR_FOC_Q15_ONE - 1);
+    return current;
+}
+
+static mr_err_t mr_foc_adc_cb(mr_device_t device, void *args)
+{
+    mr_adc_scan_block_t block = (mr_adc_scan_block_t)args;
+    struct mr_pwm_duty pwm_duty = {0};
+    mr_uint32_t duty[3] = {0};
+    mr_list_t list = MR_NULL;
+
+    /* Find the foc sampled by the adc */
+    for (list = foc_list.next; list != &foc_list; list = list->next)
+    {
+        mr_foc_t foc = (mr_foc_t)mr_container_of(list, struct mr_foc, list);
+
+        if (foc->adc == device && block->count >= foc->channels)
+        {
+            /* The latest frame of the completed half */
+            mr_uint16_t *frame = block->buffer + block->count - foc->channels;
+
+            mr_foc_step(foc,
+                        mr_foc_sample_to_current(foc, frame[foc->index_a], 0),
+                        mr_foc_sample_to_current(foc, frame[foc->index_b], 1),
+                        duty);
+
+            /* The three duties take effect on the same period */
+            pwm_duty.channel._mask = MR_FOC_PWM_CHANNEL_MASK;
+            pwm_duty.duty = duty;
+            mr_device_ioctl(foc->pwm, MR_DEVICE_CTRL_PWM_WRITE_MULTI, &pwm_duty);
+        }
+    }
+
+    return MR_ERR_OK;
+}
+
+/**
+ * @brief This function gets the sine and cosine of an electrical angle.
+ *
+ * @param angle The electrical angle (65536 per turn).
+ * @param sin The sine (Q15).
+ * @param cos The cosine (Q15).
+ */
+void mr_foc_sin_cos(mr_uint16_t angle, mr_int32_t *sin, mr_int32_t *cos)
+{
+    MR_ASSERT(sin != MR_NULL);
+    MR_ASSERT(cos != MR_NULL);
+
+    *sin = mr_foc_sine(angle);
+    *cos = mr_foc_sine((mr_uint16_t)(angle + 0x4000));
+}
+
+/**
+ * @brief This function transforms the phase currents to the stationary frame (Clarke).
+ *
+ * @param a The phase a current (Q15).
+ * @param b The phase b current (Q15).
+ * @param ab The stationary frame.
+ *
+ * @note The phase currents sum to zero, the phase c current is not needed.
+ */
+void mr_foc_clarke(mr_int32_t a, mr_int32_t b, mr_foc_ab_t ab)
+{
+    MR_ASSERT(ab != MR_NULL);
+
+    /* beta = (a + 2b) / sqrt(3) */
+    ab->alpha = a;
+    ab->beta = ((a + 2 * b) * 18919 + 16384) >> 15;
+}
+
+/**
+ * @brief This function transforms the stationary frame to the rotating frame (Park).
+ *
+ * @param ab The stationary frame.
+ * @param sin The sine of the electrical angle (Q15).
+ * @param cos The cosine of the electrical angle (Q15).
+ * @param dq The rotating frame.
+ */
+void mr_foc_park(mr_foc_ab_t ab, mr_int32_t sin, mr_int32_t cos, mr_foc_dq_t dq)
+{
+    MR_ASSERT(ab != MR_NULL);
+    MR_ASSERT(dq != MR_NULL);
+
+    dq->d = ((ab->alpha * cos) >> 15) + ((ab->beta * sin) >> 15);
+    dq->q = ((ab->beta * cos) >> 15) - ((ab->alpha * sin) >> 15);
+}
+
+/**
+ * @brief This function transforms the rotating frame to the stationary frame (inverse Park).
+ *
+ * @param dq The rotating frame.
+ * @param sin The sine of the electrical angle (Q15).
+ * @param cos The cosine of the electrical angle (Q15).
+ * @param ab The stationary frame.
+ */
+void mr_foc_inv_park(mr_foc_dq_t dq, mr_int32_t sin, mr_int32_t cos, mr_foc_ab_t ab)
+{
+    MR_ASSERT(dq != MR_NULL);
+    MR_ASSERT(ab != MR_NULL);
+
+    ab->alpha = ((dq->d * cos) >> 15) - ((dq->q * sin) >> 15);
+    ab->beta = ((dq->d * sin) >> 15) + ((dq->q * cos) >> 15);
+}
+
+/**
+ * @brief This function modulates a voltage vector to the phase duties (SVPWM).
+ *
+ * @param ab The voltage vector (Q15 of the bus voltage).
+ * @param duty The duties of phase a, b and c (MR_PWM_DUTY_MAX is 100%).
+ *
+ * @note Vectors up to MR_FOC_VOLTAGE_MAX are linear, longer vectors are clipped by the duties.
+ */
+void mr_foc_svpwm(mr_foc_ab_t ab, mr_uint32_t *duty)
+{
+    mr_int32_t phase[3] = {0}, max = 0, min = 0, value = 0;
+    mr_size_t count = 0;
+
+    MR_ASSERT(ab != MR_NULL);
+    MR_ASSERT(duty != MR_NULL);
+
+    /* Inverse Clarke, sqrt(3) / 2 = 28378 (Q15) */
+    phase[0] = ab->alpha;
+    phase[1] = -(ab->alpha >> 1) + ((ab->beta * 28378) >> 15);
+    phase[2] = -(ab->alpha >> 1) - ((ab->beta * 28378) >> 15);
+
+    /* Min-max injection centers the phases, equivalent to the seven segment svpwm */
+    max = min = phase[0];
+    for (count = 1; count < 3; count++)
+    {
+        max = (phase[count] > max) ? phase[count] : max;
+        min = (phase[count] < min) ? phase[count] : min;
+    }
+
+    for (count = 0; count < 3; count++)
+    {
+        value = MR_FOC_Q15_ONE / 2 + phase[count] - ((max + min) >> 1);
+        mr_limit_range(value, 0, MR_FOC_Q15_ONE);
+        duty[count] = (mr_uint32_t)(((mr_uint64_t)value * MR_PWM_DUTY_MAX) >> 15);
+    }
+}
+
+/**
+ * @brief This function updates a PI controller.
+ *
+ * @param pi The PI controller.
+ * @param error The error (Q15).
+ * @param limit The output limit (Q15).
+ *
+ * @return The output (Q15).
+ *
+ * @note The integral is clamped to the limit, it does not wind up while the output saturates.
+ */
+mr_int32_t mr_foc_pi_update(mr_foc_pi_t pi, mr_int32_t error, mr_int32_t limit)
+{
+    mr_int64_t integral = 0, output = 0, range = (mr_int64_t)limit << 12;
+
+    MR_ASSERT(pi != MR_NULL);
+    MR_ASSERT(limit >= 0);
+
+    integral = (mr_int64_t)pi->integral + (mr_int64_t)error * pi->ki;
+    mr_limit_range(integral, -range, range);
+    pi->integral = (mr_int32_t)integral;
+
+    output = ((mr_int64_t)error * pi->kp + integral) >> 12;
+    mr_limit_range(output, -limit, limit);
+
+    return (mr_int32_t)output;
+}
+
+/**
+ * @brief This function finds a foc.
+ *
+ * @param name The name of the foc.
+ *
+ * @return A pointer to the found foc, or MR_NULL if not found.
+ */
+mr_foc_t mr_foc_find(const char *name)
+{
+    MR_ASSERT(name != MR_NULL);
+
+    /* Find the foc object from the container */
+    return (mr_foc_t)mr_object_find(name, Mr_Object_Type_Module);
+}
+
+/**
+ * @brief This function adds a foc to the container.
+ *
+ * @param foc The foc to be added.
+ * @param name The name of the foc.
+ * @param config The configuration of the foc.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ */
+mr_err_t mr_foc_add(mr_foc_t foc, const char *name, mr_foc_config_t config)
+{
+    struct mr_foc_dq zero = {0};
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(foc != MR_NULL);
+    MR_ASSERT(foc->object.magic != MR_OBJECT_MAGIC);
+    MR_ASSERT(name != MR_NULL);
+    MR_ASSERT(config != MR_NULL);
+
+    /* Initialize the private fields */
+    foc->target = zero;
+    foc->current = zero;
+    foc->voltage = zero;
+    foc->angle = 0;
+    foc->speed = 0;
+    foc->channels = 0;
+    foc->index_a = 0;
+    foc->index_b = 0;
+    mr_list_init(&foc->list);
+    foc->adc = MR_NULL;
+    foc->pwm = MR_NULL;
+    mr_foc_set_config(foc, config);
+
+    /* Add the object to the container */
+    ret = mr_object_add(&foc->object, name, Mr_Object_Type_Module);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] add failed: [%d]\r\n", name, ret);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief This function removes a foc from the container.
+ *
+ * @param foc The foc to be removed.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ *
+ * @note The attached devices are detached and closed.
+ */
+mr_err_t mr_foc_remove(mr_foc_t foc)
+{
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(foc != MR_NULL);
+    MR_ASSERT(foc->object.type == Mr_Object_Type_Module);
+
+    /* Remove the object from the container */
+    ret = mr_object_remove(&foc->object);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] remove failed: [%d]\r\n", foc->object.name, ret);
+        return ret;
+    }
+
+    return mr_foc_attach(foc, MR_NULL, MR_NULL);
+}
+
+/**
+ * @brief This function attaches the adc and pwm devices to the foc.
+ *
+ * @param foc The foc.
+ * @param adc_name The name of the adc device sampling the phase currents, MR_NULL to detach.
+ * @param pwm_name The name of the pwm device driving the phases.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ *
+ * @note Both devices are configured by the user before. The pwm channels 1, 2 and 3 drive the phases a, b and c,
+ *       its trigger point starts the externally triggered adc scan of the enabled channels once per period.
+ */
+mr_err_t mr_foc_attach(mr_foc_t foc, const char *adc_name, const char *pwm_name)
+{
+#if (MR_CFG_DEVICE == MR_CFG_ENABLE)
+    struct mr_adc_config adc_config = {0};
+    struct mr_adc_scan scan = {0};
+    mr_device_t adc = MR_NULL, pwm = MR_NULL;
+    mr_size_t channel = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(foc != MR_NULL);
+    MR_ASSERT(adc_name == MR_NULL || pwm_name != MR_NULL);
+
+    /* Detach the previous devices */
+    if (foc->adc != MR_NULL)
+    {
+        mr_device_ioctl(foc->adc, MR_DEVICE_CTRL_ADC_STOP_SCAN, MR_NULL);
+        mr_device_close(foc->adc);
+        mr_device_close(foc->pwm);
+
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        mr_list_remove(&foc->list);
+        foc->adc = MR_NULL;
+        foc->pwm = MR_NULL;
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
+    }
+
+    if (adc_name == MR_NULL)
+    {
+        return MR_ERR_OK;
+    }
+
+    /* Find the devices */
+    adc = mr_device_find(adc_name);
+    pwm = mr_device_find(pwm_name);
+    if (adc == MR_NULL || adc->type != Mr_Device_Type_ADC || pwm == MR_NULL || pwm->type != Mr_Device_Type_PWM)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach failed: [%d]\r\n", foc->object.name, MR_ERR_NOT_FOUND);
+        return MR_ERR_NOT_FOUND;
+    }
+
+    /* Locate the phase currents in the scan frame */
+    mr_device_ioctl(adc, MR_DEVICE_CTRL_GET_CONFIG, &adc_config);
+    if (adc_config.channel._mask & ~((1u << MR_FOC_SCAN_CHANNEL_MAX) - 1)
+        || (adc_config.channel._mask & (1u << foc->config.channel_a)) == 0
+        || (adc_config.channel._mask & (1u << foc->config.channel_b)) == 0
+        || foc->config.channel_a == foc->config.channel_b)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach failed: [%d]\r\n", foc->object.name, MR_ERR_INVALID);
+        return MR_ERR_INVALID;
+    }
+    foc->channels = 0;
+    for (channel = 0; channel < MR_FOC_SCAN_CHANNEL_MAX; channel++)
+    {
+        if (adc_config.channel._mask & (1u << channel))
+        {
+            if (channel == foc->config.channel_a)
+            {
+                foc->index_a = foc->channels;
+            }
+            if (channel == foc->config.channel_b)
+            {
+                foc->index_b = foc->channels;
+            }
+            foc->channels++;
+        }
+    }
+
+    ret = mr_device_open(adc, MR_DEVICE_OFLAG_RDONLY);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach [%s] failed: [%d]\r\n", foc->object.name, adc_name, ret);
+        return ret;
+    }
+    ret = mr_device_open(pwm, MR_DEVICE_OFLAG_RDWR);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach [%s] failed: [%d]\r\n", foc->object.name, pwm_name, ret);
+        mr_device_close(adc);
+        return ret;
+    }
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    foc->adc = adc;
+    foc->pwm = pwm;
+    mr_list_insert_before(&foc_list, &foc->list);
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    /* Every frame scanned at the pwm trigger point runs one loop */
+    scan.buffer = foc->buffer;
+    scan.count = 2 * foc->channels;
+    scan.rate = 0;
+    mr_device_ioctl(adc, MR_DEVICE_CTRL_SET_RX_CB, mr_foc_adc_cb);
+    ret = mr_device_ioctl(adc, MR_DEVICE_CTRL_ADC_START_SCAN, &scan);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach [%s] failed: [%d]\r\n", foc->object.name, adc_name, ret);
+        mr_foc_attach(foc, MR_NULL, MR_NULL);
+        return ret;
+    }
+
+    return MR_ERR_OK;
+#else
+    return MR_ERR_UNSUPPORTED;
+#endif
+}
+
+/**
+ * @brief This function sets the configuration of the foc.
+ *
+ * @param foc The foc.
+ * @param config The configuration.
+ *
+ * @note The current loops restart from zero.
+ */
+void mr_foc_set_config(mr_foc_t foc, mr_foc_config_t config)
+{
+    MR_ASSERT(foc != MR_NULL);
+    MR_ASSERT(config != MR_NULL);
+    MR_ASSERT(config->voltage_limit >= 0 && config->voltage_limit <= MR_FOC_Q15_ONE);
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    foc->config = *config;
+    foc->pi_d.kp = foc->pi_q.kp = config->kp;
+    foc->pi_d.ki = foc->pi_q.ki = config->ki;
+    foc->pi_d.integral = foc->pi_q.integral = 0;
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+}
+
+/**
+ * @brief This function sets the target current of the foc.
+ *
+ * @param foc The foc.
+ * @param d The target d axis (flux) current (Q15).
+ * @param q The target q axis (torque) current (Q15).
+ */
+void mr_foc_set_target(mr_foc_t foc, mr_int32_t d, mr_int32_t q)
+{
+    MR_ASSERT(foc != MR_NULL);
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    foc->target.d = d;
+    foc->target.q = q;
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+}
+
+/**
+ * @brief This function sets the electrical angle of the foc.
+ *
+ * @param foc The foc.
+ * @param angle The electrical angle (65536 per turn).
+ * @param speed The angle added every loop, 0 to hold the angle.
+ *
+ * @note Set the angle from the rotor sensor, or a speed to rotate the field open loop.
+ */
+void mr_foc_set_angle(mr_foc_t foc, mr_uint16_t angle, mr_int16_t speed)
+{
+    MR_ASSERT(foc != MR_NULL);
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    foc->angle = angle;
+    foc->speed = speed;
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+}
+
+/**
+ * @brief This function runs one loop of the foc.
+ *
+ * @param foc The foc.
+ * @param a The phase a current (Q15).
+ * @param b The phase b current (Q15).
+ * @param duty The duties of phase a, b and c (MR_PWM_DUTY_MAX is 100%).
+ *
+ * @note The attached adc runs the loop itself, call this without devices (e.g. in a simulation).
+ */
+void mr_foc_step(mr_foc_t foc, mr_int32_t a, mr_int32_t b, mr_uint32_t *duty)
+{
+    struct mr_foc_ab ab = {0};
+    mr_int32_t sin = 0, cos = 0, limit = 0;
+
+    MR_ASSERT(foc != MR_NULL);
+    MR_ASSERT(duty != MR_NULL);
+
+    mr_foc_sin_cos(foc->angle, &sin, &cos);
+
+    /* Measure */
+    mr_foc_clarke(a, b, &ab);
+    mr_foc_park(&ab, sin, cos, &foc->current);
+
+    /* The d axis comes first, the q axis gets the rest of the voltage vector */
+    foc->voltage.d = mr_foc_pi_update(&foc->pi_d, foc->target.d - foc->current.d, foc->config.voltage_limit);
+    limit = (mr_int32_t)mr_foc_sqrt((mr_uint32_t)(foc->config.voltage_limit * foc->config.voltage_limit)
+                                    - (mr_uint32_t)(foc->voltage.d * foc->voltage.d));
+    foc->voltage.q = mr_foc_pi_update(&foc->pi_q, foc->target.q - foc->current.q, limit);
+
+    /* Modulate */
+    mr_foc_inv_park(&foc->voltage, sin, cos, &ab);
+    mr_foc_svpwm(&ab, duty);
+
+    foc->angle += foc->speed;
+}
+
+#endif
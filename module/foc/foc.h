@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023, mr-library Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2023-11-20     MacRsh       first version
+ */
+
+#ifndef _FOC_H_
+#define _FOC_H_
+
+#include "device/adc.h"
+#include "device/pwm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MR_CFG_ADC != MR_CFG_ENABLE || MR_CFG_PWM != MR_CFG_ENABLE)
+#error "Please enable ADC and PWM first!"
+#elif (MR_CFG_FOC == MR_CFG_ENABLE)
+
+/**
+ * @def FOC fixed-point units
+ */
+#define MR_FOC_Q15_ONE                  32768                       /* 1.0 of currents, voltages and sin/cos */
+#define MR_FOC_GAIN_UNIT                4096                        /* 1.0 of gains (Q12) */
+#define MR_FOC_VOLTAGE_MAX              18918                       /* Linear range of the svpwm, 1/sqrt(3) */
+
+/**
+ * @def FOC scan frame
+ */
+#define MR_FOC_SCAN_CHANNEL_MAX         18                          /* ADC channels of a scan frame */
+
+/**
+ * @def FOC default config
+ */
+#define MR_FOC_CONFIG_DEFAULT           \
+{                                       \
+    0,                                  \
+    1,                                  \
+    {2048, 2048},                       \
+    16 * MR_FOC_GAIN_UNIT,              \
+    MR_FOC_GAIN_UNIT,                   \
+    0,                                  \
+    MR_FOC_VOLTAGE_MAX,                 \
+}
+
+/**
+ * @struct FOC config
+ */
+struct mr_foc_config
+{
+    mr_uint32_t channel_a;                                          /* ADC channel of the phase a current */
+    mr_uint32_t channel_b;                                          /* ADC channel of the phase b current */
+    mr_int32_t offset[2];                                           /* Zero current samples of phase a and b */
+    mr_int32_t current_gain;                                        /* Current per sample (Q12) */
+    mr_int32_t kp;                                                  /* Proportional gain (Q12) */
+    mr_int32_t ki;                                                  /* Integral gain per loop (Q12) */
+    mr_int32_t voltage_limit;                                       /* Voltage vector limit (Q15 of the bus) */
+};
+typedef struct mr_foc_config *mr_foc_config_t;
+
+/**
+ * @struct FOC stationary frame (alpha-beta)
+ */
+struct mr_foc_ab
+{
+    mr_int32_t alpha;
+    mr_int32_t beta;
+};
+typedef struct mr_foc_ab *mr_foc_ab_t;
+
+/**
+ * @struct FOC rotating frame (d-q)
+ */
+struct mr_foc_dq
+{
+    mr_int32_t d;
+    mr_int32_t q;
+};
+typedef struct mr_foc_dq *mr_foc_dq_t;
+
+/**
+ * @struct FOC PI controller
+ */
+struct mr_foc_pi
+{
+    mr_int32_t kp;                                                  /* Proportional gain (Q12) */
+    mr_int32_t ki;                                                  /* Integral gain per loop (Q12) */
+    mr_int32_t integral;                                            /* Integral (Q15 << 12) */
+};
+typedef struct mr_foc_pi *mr_foc_pi_t;
+
+/**
+ * @struct FOC
+ */
+struct mr_foc
+{
+    struct mr_object object;                                        /* FOC object */
+
+    struct mr_foc_config config;                                    /* Config */
+    struct mr_foc_dq target;                                        /* Target current */
+    struct mr_foc_dq current;                                       /* Measured current */
+    struct mr_foc_dq voltage;                                       /* Applied voltage */
+    struct mr_foc_pi pi_d;                                          /* Current loop of the d axis */
+    struct mr_foc_pi pi_q;                                          /* Current loop of the q axis */
+    mr_uint16_t angle;                                              /* Electrical angle (65536 per turn) */
+    mr_int16_t speed;                                               /* Angle added every loop */
+
+    mr_uint16_t buffer[2 * MR_FOC_SCAN_CHANNEL_MAX];                /* Scan buffer (one frame per half) */
+    mr_size_t channels;                                             /* Scanned channels */
+    mr_size_t index_a;                                              /* Phase a in the scan frame */
+    mr_size_t index_b;                                              /* Phase b in the scan frame */
+    struct mr_list list;                                            /* Attached list */
+    mr_device_t adc;                                                /* Attached adc device */
+    mr_device_t pwm;                                                /* Attached pwm device */
+};
+typedef struct mr_foc *mr_foc_t;                                    /* Type for foc */
+
+/**
+ * @addtogroup FOC
+ * @{
+ */
+void mr_foc_sin_cos(mr_uint16_t angle, mr_int32_t *sin, mr_int32_t *cos);
+void mr_foc_clarke(mr_int32_t a, mr_int32_t b, mr_foc_ab_t ab);
+void mr_foc_park(mr_foc_ab_t ab, mr_int32_t sin, mr_int32_t cos, mr_foc_dq_t dq);
+void mr_foc_inv_park(mr_foc_dq_t dq, mr_int32_t sin, mr_int32_t cos, mr_foc_ab_t ab);
+void mr_foc_svpwm(mr_foc_ab_t ab, mr_uint32_t *duty);
+mr_int32_t mr_foc_pi_update(mr_foc_pi_t pi, mr_int32_t error, mr_int32_t limit);
+mr_foc_t mr_foc_find(const char *name);
+mr_err_t mr_foc_add(mr_foc_t foc, const char *name, mr_foc_config_t config);
+mr_err_t mr_foc_remove(mr_foc_t foc);
+mr_err_t mr_foc_attach(mr_foc_t foc, const char *adc_name, const char *pwm_name);
+void mr_foc_set_config(mr_foc_t foc, mr_foc_config_t config);
+void mr_foc_set_target(mr_foc_t foc, mr_int32_t d, mr_int32_t q);
+void mr_foc_set_angle(mr_foc_t foc, mr_uint16_t angle, mr_int16_t speed);
+void mr_foc_step(mr_foc_t foc, mr_int32_t a, mr_int32_t b, mr_uint32_t *duty);
+/** @} */
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FOC_H_ */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2023, mr-library Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2023-11-22     MacRsh       first version
+ */
+
+/*
+ * Host simulation of the foc current loop, mr_foc_step drives a surface pmsm model.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -I include -I . -DMR_CFG_FOC=MR_CFG_ENABLE module/foc/foc_sim.c module/foc/foc.c \
+ *       device/adc.c device/pwm.c src/kernel.c src/kservice.c src/device.c -lm -o foc_sim
+ *   ./foc_sim
+ *
+ * The exit code is 0 when the currents settle on the targets and the motor accelerates.
+ */
+
+#include "foc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/**
+ * @def Simulation motor and inverter
+ */
+#define SIM_BUS_VOLTAGE                 24.0                        /* Bus voltage (V) */
+#define SIM_CURRENT_FULL_SCALE          10.0                        /* Current of MR_FOC_Q15_ONE (A) */
+#define SIM_RESISTANCE                  0.5                         /* Phase resistance (ohm) */
+#define SIM_INDUCTANCE                  0.0005                      /* Phase inductance (H) */
+#define SIM_FLUX                        0.005                       /* Rotor flux linkage (Wb) */
+#define SIM_POLE_PAIRS                  4                           /* Pole pairs */
+#define SIM_INERTIA                     0.00002                     /* Rotor inertia (kg*m^2) */
+#define SIM_FRICTION                    0.0004                      /* Viscous friction and load (N*m*s/rad) */
+
+/**
+ * @def Simulation timing
+ */
+#define SIM_PWM_FREQ                    20000                       /* Control loop rate (Hz) */
+#define SIM_SUB_STEPS                   20                          /* Model steps per control loop */
+#define SIM_LOOPS                       4000                        /* Control loops (200ms) */
+#define SIM_TRACE_LOOPS                 500                         /* Loops between trace lines */
+
+/**
+ * @def Simulation targets and tolerance
+ */
+#define SIM_TARGET_Q                    (MR_FOC_Q15_ONE / 4)        /* 2.5A torque current */
+#define SIM_TOLERANCE                   (MR_FOC_Q15_ONE / 100)      /* 1% of the full scale current */
+
+/**
+ * @struct Simulation motor state
+ */
+struct sim_motor
+{
+    double alpha;                                                   /* Alpha current (A) */
+    double beta;                                                    /* Beta current (A) */
+    double speed;                                                   /* Mechanical speed (rad/s) */
+    double angle;                                                   /* Electrical angle (rad) */
+};
+
+static void sim_motor_step(struct sim_motor *motor, const mr_uint32_t *duty)
+{
+    double dt = 1.0 / SIM_PWM_FREQ / SIM_SUB_STEPS;
+    double va = 0, vb = 0, vc = 0, vn = 0, v_alpha = 0, v_beta = 0;
+    double speed_e = 0, torque = 0, iq = 0;
+    int i = 0;
+
+    /* Phase voltages of the averaged inverter, the star point floats */
+    va = (double)duty[0] / MR_PWM_DUTY_MAX * SIM_BUS_VOLTAGE;
+    vb = (double)duty[1] / MR_PWM_DUTY_MAX * SIM_BUS_VOLTAGE;
+    vc = (double)duty[2] / MR_PWM_DUTY_MAX * SIM_BUS_VOLTAGE;
+    vn = (va + vb + vc) / 3.0;
+    v_alpha = va - vn;
+    v_beta = ((vb - vn) - (vc - vn)) / sqrt(3.0);
+
+    for (i = 0; i < SIM_SUB_STEPS; i++)
+    {
+        speed_e = motor->speed * SIM_POLE_PAIRS;
+
+        /* Stator: L di/dt = v - R i - e */
+        motor->alpha += dt * (v_alpha - SIM_RESISTANCE * motor->alpha
+                              + speed_e * SIM_FLUX * sin(motor->angle)) / SIM_INDUCTANCE;
+        motor->beta += dt * (v_beta - SIM_RESISTANCE * motor->beta
+                             - speed_e * SIM_FLUX * cos(motor->angle)) / SIM_INDUCTANCE;
+
+        /* Rotor: J dw/dt = 1.5 p flux iq - B w */
+        iq = -motor->alpha * sin(motor->angle) + motor->beta * cos(motor->angle);
+        torque = 1.5 * SIM_POLE_PAIRS * SIM_FLUX * iq;
+        motor->speed += dt * (torque - SIM_FRICTION * motor->speed) / SIM_INERTIA;
+        motor->angle = fmod(motor->angle + dt * speed_e, 2.0 * M_PI);
+    }
+}
+
+static mr_int32_t sim_to_q15(double current)
+{
+    return (mr_int32_t)lround(current / SIM_CURRENT_FULL_SCALE * MR_FOC_Q15_ONE);
+}
+
+static double sim_check_sin_cos(void)
+{
+    mr_int32_t sin_q15 = 0, cos_q15 = 0;
+    double error = 0, max_error = 0;
+    mr_uint32_t angle = 0;
+
+    for (angle = 0; angle < 65536; angle++)
+    {
+        mr_foc_sin_cos((mr_uint16_t)angle, &sin_q15, &cos_q15);
+        error = fabs(sin_q15 - MR_FOC_Q15_ONE * sin(angle * 2.0 * M_PI / 65536));
+        max_error = (error > max_error) ? error : max_error;
+        error = fabs(cos_q15 - MR_FOC_Q15_ONE * cos(angle * 2.0 * M_PI / 65536));
+        max_error = (error > max_error) ? error : max_error;
+    }
+
+    return max_error;
+}
+
+int main(void)
+{
+    struct mr_foc foc;
+    struct mr_foc_config config = MR_FOC_CONFIG_DEFAULT;
+    struct sim_motor motor = {0};
+    mr_uint32_t duty[3] = {MR_PWM_DUTY_MAX / 2, MR_PWM_DUTY_MAX / 2, MR_PWM_DUTY_MAX / 2};
+    double bandwidth = 2.0 * M_PI * 1000.0, max_error = 0;
+    int loop = 0, ret = 0;
+
+    max_error = sim_check_sin_cos();
+    printf("sin/cos max error: %.2f (q15)\n", max_error);
+
+    /* Pole-zero cancellation, 1kHz current loop bandwidth */
+    config.kp = (mr_int32_t)lround(SIM_INDUCTANCE * bandwidth * SIM_CURRENT_FULL_SCALE / SIM_BUS_VOLTAGE
+                                   * MR_FOC_GAIN_UNIT);
+    config.ki = (mr_int32_t)lround(SIM_RESISTANCE * bandwidth / SIM_PWM_FREQ * SIM_CURRENT_FULL_SCALE
+                                   / SIM_BUS_VOLTAGE * MR_FOC_GAIN_UNIT);
+    printf("kp: %d, ki: %d (q12)\n", (int)config.kp, (int)config.ki);
+
+    mr_foc_add(&foc, "foc", &config);
+    mr_foc_set_target(&foc, 0, SIM_TARGET_Q);
+
+    for (loop = 0; loop < SIM_LOOPS; loop++)
+    {
+        /* Sample the currents and the encoder, the duties take effect for the next period */
+        mr_foc_set_angle(&foc, (mr_uint16_t)lround(motor.angle / (2.0 * M_PI) * 65536.0), 0);
+        mr_foc_step(&foc,
+                    sim_to_q15(motor.alpha),
+                    sim_to_q15(-0.5 * motor.alpha + sqrt(3.0) / 2.0 * motor.beta),
+                    duty);
+        sim_motor_step(&motor, duty);
+
+        if (loop % SIM_TRACE_LOOPS == 0 || loop == SIM_LOOPS - 1)
+        {
+            printf("loop %4d: id %6d, iq %6d, vd %6d, vq %6d, duty %7u %7u %7u, speed %7.1f rpm\n",
+                   loop,
+                   (int)foc.current.d,
+                   (int)foc.current.q,
+                   (int)foc.voltage.d,
+                   (int)foc.voltage.q,
+                   (unsigned)duty[0],
+                   (unsigned)duty[1],
+                   (unsigned)duty[2],
+                   motor.speed * 60.0 / (2.0 * M_PI));
+        }
+    }
+
+    if (max_error > 8.0)
+    {
+        printf("fail: sin/cos error\n");
+        ret = 1;
+    }
+    if (abs(foc.current.d) > SIM_TOLERANCE || abs(foc.current.q - SIM_TARGET_Q) > SIM_TOLERANCE)
+    {
+        printf("fail: currents off the targets\n");
+        ret = 1;
+    }
+    if (motor.speed <= 0)
+    {
+        printf("fail: the motor does not accelerate\n");
+        ret = 1;
+    }
+    printf("%s\n", (ret == 0) ? "pass" : "fail");
+
+    return ret;
+}
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2023, mr-library Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2023-11-06     MacRsh       first version
+ */
+
+#include "swtimer.h"
+
+#if (MR_CFG_SWTIMER == MR_CFG_ENABLE)
+
+#define DEBUG_TAG   "swtimer"
+
+/* Ticks covered by the whole wheel, longer timeouts cascade from the top level again */
+#define MR_SWTIMER_WHEEL_RANGE          (1u << (MR_SWTIMER_WHEEL_BITS * MR_SWTIMER_WHEEL_LEVEL))
+
+static struct mr_list swtimer_wheel_list = {&swtimer_wheel_list, &swtimer_wheel_list};
+
+static void mr_swtimer_wheel_insert(mr_swtimer_wheel_t wheel, mr_swtimer_t timer)
+{
+    mr_uint32_t delta = timer->timeout - wheel->tick;
+    mr_uint32_t timeout = timer->timeout;
+    mr_uint32_t level = 0;
+
+    /* Park the timer at the end of the wheel, it is placed again when cascaded */
+    if (delta >= MR_SWTIMER_WHEEL_RANGE)
+    {
+        timeout = wheel->tick + MR_SWTIMER_WHEEL_RANGE - 1;
+        delta = MR_SWTIMER_WHEEL_RANGE - 1;
+    }
+
+    /* The level whose range covers the remaining ticks */
+    while ((delta >> (MR_SWTIMER_WHEEL_BITS * (level + 1))) != 0)
+    {
+        level++;
+    }
+
+    mr_list_insert_before(&wheel->slot[level][(timeout >> (MR_SWTIMER_WHEEL_BITS * level)) & MR_SWTIMER_WHEEL_MASK],
+                          &timer->list);
+}
+
+static void mr_swtimer_wheel_cascade(mr_swtimer_wheel_t wheel, mr_uint32_t level)
+{
+    mr_list_t slot = &wheel->slot[level][(wheel->tick >> (MR_SWTIMER_WHEEL_BITS * level)) & MR_SWTIMER_WHEEL_MASK];
+
+    /* Spread the timers of the slot over the lower levels */
+    while (mr_list_is_empty(slot) == MR_FALSE)
+    {
+        mr_swtimer_t timer = (mr_swtimer_t)mr_container_of(slot->next, struct mr_swtimer, list);
+
+        mr_list_remove(&timer->list);
+        mr_swtimer_wheel_insert(wheel, timer);
+    }
+}
+
+static mr_err_t mr_swtimer_wheel_timer_cb(mr_device_t device, void *args)
+{
+    mr_list_t list = MR_NULL;
+
+    /* Find the wheel driven by the timer */
+    for (list = swtimer_wheel_list.next; list != &swtimer_wheel_list; list = list->next)
+    {
+        mr_swtimer_wheel_t wheel = (mr_swtimer_wheel_t)mr_container_of(list, struct mr_swtimer_wheel, list);
+
+        if (wheel->timer == device)
+        {
+            mr_swtimer_wheel_tick_update(wheel);
+        }
+    }
+
+    return MR_ERR_OK;
+}
+
+/**
+ * @brief This function finds a swtimer wheel.
+ *
+ * @param name The name of the swtimer wheel.
+ *
+ * @return A pointer to the found swtimer wheel, or MR_NULL if not found.
+ */
+mr_swtimer_wheel_t mr_swtimer_wheel_find(const char *name)
+{
+    MR_ASSERT(name != MR_NULL);
+
+    /* Find the swtimer wheel object from the container */
+    return (mr_swtimer_wheel_t)mr_object_find(name, Mr_Object_Type_Module);
+}
+
+/**
+ * @brief This function adds a swtimer wheel to the container.
+ *
+ * @param wheel The swtimer wheel to be added.
+ * @param name The name of the swtimer wheel.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ */
+mr_err_t mr_swtimer_wheel_add(mr_swtimer_wheel_t wheel, const char *name)
+{
+    mr_size_t level = 0, index = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(wheel != MR_NULL);
+    MR_ASSERT(wheel->object.magic != MR_OBJECT_MAGIC);
+    MR_ASSERT(name != MR_NULL);
+
+    /* Initialize the private fields */
+    wheel->tick = 0;
+    for (level = 0; level < MR_SWTIMER_WHEEL_LEVEL; level++)
+    {
+        for (index = 0; index < MR_SWTIMER_WHEEL_SIZE; index++)
+        {
+            mr_list_init(&wheel->slot[level][index]);
+        }
+    }
+    mr_list_init(&wheel->pending);
+    mr_list_init(&wheel->list);
+    wheel->timer = MR_NULL;
+
+    /* Add the object to the container */
+    ret = mr_object_add(&wheel->object, name, Mr_Object_Type_Module);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] add failed: [%d]\r\n", name, ret);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief This function removes a swtimer wheel from the container.
+ *
+ * @param wheel The swtimer wheel to be removed.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ *
+ * @note The timers still running on the wheel are stopped.
+ */
+mr_err_t mr_swtimer_wheel_remove(mr_swtimer_wheel_t wheel)
+{
+    mr_size_t level = 0, index = 0;
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(wheel != MR_NULL);
+    MR_ASSERT(wheel->object.type == Mr_Object_Type_Module);
+
+    /* Remove the object from the container */
+    ret = mr_object_remove(&wheel->object);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] remove failed: [%d]\r\n", wheel->object.name, ret);
+        return ret;
+    }
+
+    /* Detach the timer device */
+    mr_swtimer_wheel_attach(wheel, MR_NULL, 0);
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    /* Stop every timer */
+    for (level = 0; level < MR_SWTIMER_WHEEL_LEVEL; level++)
+    {
+        for (index = 0; index < MR_SWTIMER_WHEEL_SIZE; index++)
+        {
+            while (mr_list_is_empty(&wheel->slot[level][index]) == MR_FALSE)
+            {
+                mr_list_remove(wheel->slot[level][index].next);
+            }
+        }
+    }
+    while (mr_list_is_empty(&wheel->pending) == MR_FALSE)
+    {
+        mr_list_remove(wheel->pending.next);
+    }
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    return MR_ERR_OK;
+}
+
+/**
+ * @brief This function attaches a timer device as the tick source of the swtimer wheel.
+ *
+ * @param wheel The swtimer wheel.
+ * @param name The name of the timer device, MR_NULL to detach.
+ * @param period The tick period(us).
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ *
+ * @note Without a timer device, call mr_swtimer_wheel_tick_update() from any periodic tick instead.
+ */
+mr_err_t mr_swtimer_wheel_attach(mr_swtimer_wheel_t wheel, const char *name, mr_uint32_t period)
+{
+#if (MR_CFG_DEVICE == MR_CFG_ENABLE)
+    mr_device_t timer = MR_NULL;
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(wheel != MR_NULL);
+    MR_ASSERT(name == MR_NULL || period > 0);
+
+    /* Detach the previous timer device */
+    if (wheel->timer != MR_NULL)
+    {
+        mr_device_write(wheel->timer, 0, &period, 0);
+        mr_device_close(wheel->timer);
+
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        mr_list_remove(&wheel->list);
+        wheel->timer = MR_NULL;
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
+    }
+
+    if (name == MR_NULL)
+    {
+        return MR_ERR_OK;
+    }
+
+    /* Find the timer device */
+    timer = mr_device_find(name);
+    if (timer == MR_NULL || timer->type != Mr_Device_Type_Timer)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach [%s] failed: [%d]\r\n", wheel->object.name, name, MR_ERR_NOT_FOUND);
+        return MR_ERR_NOT_FOUND;
+    }
+
+    ret = mr_device_open(timer, MR_DEVICE_OFLAG_RDWR);
+    if (ret != MR_ERR_OK)
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach [%s] failed: [%d]\r\n", wheel->object.name, name, ret);
+        return ret;
+    }
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    wheel->timer = timer;
+    mr_list_insert_before(&swtimer_wheel_list, &wheel->list);
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    /* Every timeout of the timer is one tick */
+    mr_device_ioctl(timer, MR_DEVICE_CTRL_SET_RX_CB, mr_swtimer_wheel_timer_cb);
+    if (mr_device_write(timer, 0, &period, sizeof(period)) != sizeof(period))
+    {
+        MR_DEBUG_D(DEBUG_TAG, "[%s] attach [%s] failed: [%d]\r\n", wheel->object.name, name, MR_ERR_INVALID);
+        mr_swtimer_wheel_attach(wheel, MR_NULL, 0);
+        return MR_ERR_INVALID;
+    }
+
+    return MR_ERR_OK;
+#else
+    return MR_ERR_UNSUPPORTED;
+#endif
+}
+
+/**
+ * @brief This function update ticks the swtimer wheel.
+ *
+ * @param wheel The swtimer wheel to be updated.
+ *
+ * @note Hard timers are called back here, the others are left to mr_swtimer_wheel_handle().
+ */
+void mr_swtimer_wheel_tick_update(mr_swtimer_wheel_t wheel)
+{
+    struct mr_list expired = {&expired, &expired};
+    mr_list_t slot = MR_NULL;
+    mr_uint32_t level = 0;
+
+    MR_ASSERT(wheel != MR_NULL);
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    wheel->tick++;
+
+    /* Each time a level wraps around, the next slot of the upper level is due */
+    for (level = 1; level < MR_SWTIMER_WHEEL_LEVEL; level++)
+    {
+        if ((wheel->tick & ((1u << (MR_SWTIMER_WHEEL_BITS * level)) - 1)) != 0)
+        {
+            break;
+        }
+        mr_swtimer_wheel_cascade(wheel, level);
+    }
+
+    /* Take every timer expiring on this tick */
+    slot = &wheel->slot[0][wheel->tick & MR_SWTIMER_WHEEL_MASK];
+    if (mr_list_is_empty(slot) == MR_FALSE)
+    {
+        expired.next = slot->next;
+        expired.prev = slot->prev;
+        expired.next->prev = &expired;
+        expired.prev->next = &expired;
+        mr_list_init(slot);
+    }
+
+    while (mr_list_is_empty(&expired) == MR_FALSE)
+    {
+        mr_swtimer_t timer = (mr_swtimer_t)mr_container_of(expired.next, struct mr_swtimer, list);
+
+        mr_list_remove(&timer->list);
+
+        /* Rearm a period timer from its timeout, the interval does not drift */
+        if ((timer->sflags & MR_SWTIMER_SFLAG_ONESHOT) == 0)
+        {
+            timer->timeout += timer->interval;
+            mr_swtimer_wheel_insert(wheel, timer);
+        }
+
+        if (timer->sflags & MR_SWTIMER_SFLAG_HARD)
+        {
+            /* Enable interrupt */
+            mr_interrupt_enable();
+
+            /* Call the callback */
+            timer->cb(timer, timer->args);
+
+            /* Disable interrupt */
+            mr_interrupt_disable();
+        } else if (mr_list_is_empty(&timer->plist) == MR_TRUE)
+        {
+            mr_list_insert_before(&wheel->pending, &timer->plist);
+        }
+    }
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+}
+
+/**
+ * @brief This function handles the swtimer wheel.
+ *
+ * @param wheel The swtimer wheel to be handled.
+ *
+ * @note Only deal with what has already happened, a timer expiring several times in between is called back once.
+ */
+void mr_swtimer_wheel_handle(mr_swtimer_wheel_t wheel)
+{
+    MR_ASSERT(wheel != MR_NULL);
+    MR_ASSERT(wheel->object.type == Mr_Object_Type_Module);
+
+    while (1)
+    {
+        mr_swtimer_t timer = MR_NULL;
+
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        if (mr_list_is_empty(&wheel->pending) == MR_TRUE)
+        {
+            /* Enable interrupt */
+            mr_interrupt_enable();
+            break;
+        }
+
+        /* Take the first pending timer */
+        timer = (mr_swtimer_t)mr_container_of(wheel->pending.next, struct mr_swtimer, plist);
+        mr_list_remove(&timer->plist);
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
+
+        /* Call the callback */
+        timer->cb(timer, timer->args);
+    }
+}
+
+/**
+ * @brief This function initializes a swtimer.
+ *
+ * @param timer The swtimer to be initialized.
+ * @param sflags The start flags of the swtimer.
+ * @param cb The callback of the swtimer.
+ * @param args The args of the callback.
+ */
+void mr_swtimer_init(mr_swtimer_t timer,
+                     mr_uint8_t sflags,
+                     mr_err_t (*cb)(mr_swtimer_t timer, void *args),
+                     void *args)
+{
+    MR_ASSERT(timer != MR_NULL);
+    MR_ASSERT(cb != MR_NULL);
+
+    /* Initialize the private fields */
+    mr_list_init(&timer->list);
+    mr_list_init(&timer->plist);
+    timer->sflags = sflags;
+    timer->interval = 0;
+    timer->timeout = 0;
+    timer->wheel = MR_NULL;
+    timer->cb = cb;
+    timer->args = args;
+}
+
+/**
+ * @brief This function starts a swtimer.
+ *
+ * @param wheel The swtimer wheel to run on.
+ * @param timer The swtimer to be started.
+ * @param time The time of the swtimer(ticks).
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ *
+ * @note A running swtimer is restarted.
+ */
+mr_err_t mr_swtimer_start(mr_swtimer_wheel_t wheel, mr_swtimer_t timer, mr_uint32_t time)
+{
+    MR_ASSERT(wheel != MR_NULL);
+    MR_ASSERT(wheel->object.type == Mr_Object_Type_Module);
+    MR_ASSERT(timer != MR_NULL);
+
+    if (time == 0)
+    {
+        return MR_ERR_INVALID;
+    }
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    mr_list_remove(&timer->list);
+    mr_list_remove(&timer->plist);
+    timer->interval = time;
+    timer->timeout = wheel->tick + time;
+    timer->wheel = wheel;
+    mr_swtimer_wheel_insert(wheel, timer);
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    return MR_ERR_OK;
+}
+
+/**
+ * @brief This function stops a swtimer.
+ *
+ * @param timer The swtimer to be stopped.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ */
+mr_err_t mr_swtimer_stop(mr_swtimer_t timer)
+{
+    MR_ASSERT(timer != MR_NULL);
+
+    /* Disable interrupt */
+    mr_interrupt_disable();
+
+    /* Remove the timer from the wheel and the pending callbacks */
+    mr_list_remove(&timer->list);
+    mr_list_remove(&timer->plist);
+    timer->wheel = MR_NULL;
+
+    /* Enable interrupt */
+    mr_interrupt_enable();
+
+    return MR_ERR_OK;
+}
+
+#endif
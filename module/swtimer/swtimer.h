@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, mr-library Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2023-11-06     MacRsh       first version
+ */
+
+#ifndef _SWTIMER_H_
+#define _SWTIMER_H_
+
+#include "mrapi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MR_CFG_SWTIMER == MR_CFG_ENABLE)
+
+/**
+ * @def Swtimer wheel size
+ */
+#define MR_SWTIMER_WHEEL_BITS           6                           /* Slots per level (power of 2) */
+#define MR_SWTIMER_WHEEL_SIZE           (1u << MR_SWTIMER_WHEEL_BITS)
+#define MR_SWTIMER_WHEEL_MASK           (MR_SWTIMER_WHEEL_SIZE - 1)
+#define MR_SWTIMER_WHEEL_LEVEL          4                           /* Levels */
+
+/**
+ * @def Swtimer start flag
+ */
+#define MR_SWTIMER_SFLAG_PERIOD         0x00                        /* Period */
+#define MR_SWTIMER_SFLAG_ONESHOT        0x01                        /* Oneshot */
+#define MR_SWTIMER_SFLAG_HARD           0x02                        /* Callback in the tick (interrupt) */
+
+typedef struct mr_swtimer *mr_swtimer_t;                            /* Type for swtimer */
+
+/**
+ * @struct Swtimer
+ */
+struct mr_swtimer
+{
+    struct mr_list list;                                            /* Wheel slot list */
+    struct mr_list plist;                                           /* Pending list */
+    mr_uint8_t sflags;                                              /* Start flags */
+    mr_uint32_t interval;                                           /* Interval */
+    mr_uint32_t timeout;                                            /* Timeout tick */
+    struct mr_swtimer_wheel *wheel;                                 /* Wheel */
+
+    mr_err_t (*cb)(mr_swtimer_t timer, void *args);                 /* Callback */
+    void *args;                                                     /* Callback args */
+};
+
+/**
+ * @struct Swtimer wheel
+ */
+struct mr_swtimer_wheel
+{
+    struct mr_object object;                                        /* Swtimer wheel object */
+
+    mr_uint32_t tick;                                               /* Tick */
+    struct mr_list slot[MR_SWTIMER_WHEEL_LEVEL][MR_SWTIMER_WHEEL_SIZE]; /* Wheel slots */
+    struct mr_list pending;                                         /* Pending callbacks */
+    struct mr_list list;                                            /* Attached list */
+    mr_device_t timer;                                              /* Attached timer device */
+};
+typedef struct mr_swtimer_wheel *mr_swtimer_wheel_t;                /* Type for swtimer wheel */
+
+/**
+ * @addtogroup Swtimer
+ * @{
+ */
+mr_swtimer_wheel_t mr_swtimer_wheel_find(const char *name);
+mr_err_t mr_swtimer_wheel_add(mr_swtimer_wheel_t wheel, const char *name);
+mr_err_t mr_swtimer_wheel_remove(mr_swtimer_wheel_t wheel);
+mr_err_t mr_swtimer_wheel_attach(mr_swtimer_wheel_t wheel, const char *name, mr_uint32_t period);
+void mr_swtimer_wheel_tick_update(mr_swtimer_wheel_t wheel);
+void mr_swtimer_wheel_handle(mr_swtimer_wheel_t wheel);
+void mr_swtimer_init(mr_swtimer_t timer,
+                     mr_uint8_t sflags,
+                     mr_err_t (*cb)(mr_swtimer_t timer, void *args),
+                     void *args);
+mr_err_t mr_swtimer_start(mr_swtimer_wheel_t wheel, mr_swtimer_t timer, mr_uint32_t time);
+mr_err_t mr_swtimer_stop(mr_swtimer_t timer);
+/** @} */
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SWTIMER_H_ */
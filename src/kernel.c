@@ -10,6 +10,10 @@
 
 #include "mrapi.h"
 
+#if (MR_CFG_DEVICE == MR_CFG_ENABLE)
+#include "device/timer.h"
+#endif
+
 static struct mr_object_container mr_object_container_table[] =
     {
         {Mr_Object_Type_None,   MR_OBJECT_MAGIC, {&mr_object_container_table[Mr_Object_Type_None].list,   &mr_object_container_table[Mr_Object_Type_None].list}},
@@ -334,6 +338,218 @@ volatile void *mr_mutex_get_owner(mr_mutex_t mutex)
     return mutex->owner;
 }
 
+static mr_clock_t mr_default_clock = MR_NULL;
+
+static mr_uint64_t mr_clock_convert(mr_clock_t clock, mr_uint64_t count, mr_uint32_t scale)
+{
+    /* Split off the whole seconds, the remainder times the scale fits in 64bit */
+    return (count / clock->freq) * scale + (count % clock->freq) * scale / clock->freq;
+}
+
+/**
+ * @brief This function initialize the clock.
+ *
+ * @param clock The clock to be initialized.
+ * @param freq The frequency of the counter.
+ * @param period The counts per overflow, 0 if the counter is free running 32bit.
+ * @param get_count The function to get the counter.
+ * @param data The private data of the clock.
+ *
+ * @note A counter with period calls mr_clock_overflow() on every overflow, its get_count includes a wrap
+ *       whose overflow interrupt is still pending (up to 2 periods), as the hardware update flag tells.
+ */
+void mr_clock_init(mr_clock_t clock,
+                   mr_uint32_t freq,
+                   mr_uint32_t period,
+                   mr_uint32_t (*get_count)(mr_clock_t clock),
+                   void *data)
+{
+    MR_ASSERT(clock != MR_NULL);
+    MR_ASSERT(freq > 0);
+    MR_ASSERT(get_count != MR_NULL);
+
+    clock->freq = freq;
+    clock->period = period;
+    clock->overflow = 0;
+    clock->last = 0;
+    clock->get_count = get_count;
+    clock->data = data;
+}
+
+/**
+ * @brief This function set the default clock.
+ *
+ * @param clock The clock used as the time base of mr_clock_get_us() and mr_clock_get_ns().
+ */
+void mr_clock_set_default(mr_clock_t clock)
+{
+    mr_default_clock = clock;
+}
+
+#if (MR_CFG_DEVICE == MR_CFG_ENABLE) && (MR_CFG_TIMER == MR_CFG_ENABLE)
+static struct mr_clock mr_timer_clock;
+
+static mr_err_t mr_clock_timer_cb(mr_device_t device, void *args)
+{
+    mr_clock_overflow(&mr_timer_clock);
+
+    return MR_ERR_OK;
+}
+
+static mr_uint32_t mr_clock_timer_get_count(mr_clock_t clock)
+{
+    mr_uint32_t count = 0;
+
+    /* The time since the last timeout(us), past it while the timeout interrupt is pending */
+    mr_device_read((mr_device_t)clock->data, 0, &count, sizeof(count));
+    return count;
+}
+#endif
+
+/**
+ * @brief This function attach a timer device as the default clock.
+ *
+ * @param name The name of the timer device.
+ * @param period The timeout of the timer(us), the interrupt rate of the clock.
+ *
+ * @return MR_ERR_OK on success, otherwise an error code.
+ */
+mr_err_t mr_clock_attach(const char *name, mr_uint32_t period)
+{
+#if (MR_CFG_DEVICE == MR_CFG_ENABLE) && (MR_CFG_TIMER == MR_CFG_ENABLE)
+    mr_device_t timer = MR_NULL;
+    struct mr_timer_solution solution = {0};
+    mr_err_t ret = MR_ERR_OK;
+
+    MR_ASSERT(name != MR_NULL);
+    MR_ASSERT(period > 0);
+
+    /* Find the timer device */
+    timer = mr_device_find(name);
+    if (timer == MR_NULL || timer->type != Mr_Device_Type_Timer)
+    {
+        return MR_ERR_NOT_FOUND;
+    }
+
+    ret = mr_device_open(timer, MR_DEVICE_OFLAG_RDWR);
+    if (ret != MR_ERR_OK)
+    {
+        return ret;
+    }
+
+    /* The timer counts in us and overflows on every timeout */
+    mr_clock_init(&mr_timer_clock, 1000000u, period, mr_clock_timer_get_count, timer);
+    mr_device_ioctl(timer, MR_DEVICE_CTRL_SET_RX_CB, mr_clock_timer_cb);
+    if (mr_device_write(timer, 0, &period, sizeof(period)) < 0
+        || mr_device_ioctl(timer, MR_DEVICE_CTRL_TIMER_GET_SOLUTION, &solution) != MR_ERR_OK)
+    {
+        mr_device_close(timer);
+        return MR_ERR_INVALID;
+    }
+
+    /* The timer runs the solved timeout, which falls short of the period by the error */
+    mr_timer_clock.period = solution.timeout - solution.error;
+    mr_clock_set_default(&mr_timer_clock);
+
+    return MR_ERR_OK;
+#else
+    return MR_ERR_UNSUPPORTED;
+#endif
+}
+
+/**
+ * @brief This function counts an overflow of the clock.
+ *
+ * @param clock The clock that overflowed.
+ *
+ * @note Call it from the overflow interrupt of the counter.
+ */
+void mr_clock_overflow(mr_clock_t clock)
+{
+    MR_ASSERT(clock != MR_NULL);
+
+    clock->overflow++;
+}
+
+/**
+ * @brief This function get the 64bit count of the clock.
+ *
+ * @param clock The clock to be read.
+ *
+ * @return The count since the clock was initialized.
+ *
+ * @note A free running counter is extended on read, read it at least once per wrap.
+ *       A counter with period is read without locking, again if its overflow interrupt ran in between.
+ */
+mr_uint64_t mr_clock_get_count(mr_clock_t clock)
+{
+    mr_uint32_t overflow = 0, count = 0;
+
+    MR_ASSERT(clock != MR_NULL);
+
+    if (clock->period == 0)
+    {
+        /* Disable interrupt */
+        mr_interrupt_disable();
+
+        /* The counter wrapped since the last read */
+        count = clock->get_count(clock);
+        if (count < clock->last)
+        {
+            clock->overflow++;
+        }
+        clock->last = count;
+        overflow = clock->overflow;
+
+        /* Enable interrupt */
+        mr_interrupt_enable();
+
+        return ((mr_uint64_t)overflow << 32) | count;
+    }
+
+    do
+    {
+        overflow = clock->overflow;
+        count = clock->get_count(clock);
+    } while (overflow != clock->overflow);
+
+    return (mr_uint64_t)overflow * clock->period + count;
+}
+
+/**
+ * @brief This function get the time of the default clock(us).
+ *
+ * @return The time since the clock was initialized, 0 if without clock.
+ */
+mr_uint64_t mr_clock_get_us(void)
+{
+    mr_clock_t clock = mr_default_clock;
+
+    if (clock == MR_NULL)
+    {
+        return 0;
+    }
+
+    return mr_clock_convert(clock, mr_clock_get_count(clock), 1000000u);
+}
+
+/**
+ * @brief This function get the time of the default clock(ns).
+ *
+ * @return The time since the clock was initialized, 0 if without clock.
+ */
+mr_uint64_t mr_clock_get_ns(void)
+{
+    mr_clock_t clock = mr_default_clock;
+
+    if (clock == MR_NULL)
+    {
+        return 0;
+    }
+
+    return mr_clock_convert(clock, mr_clock_get_count(clock), 1000000000u);
+}
+
 /**
  * @brief This function allocate memory.
  *
@@ -179,6 +179,47 @@ MR_WEAK void mr_interrupt_enable(void)
 
 }
 
+/**
+ * @brief This function delay the ns.
+ *
+ * @param ns The ns to delay.
+ *
+ * @note The default rounds up to us, override it with a calibrated cycle delay for sub-us resolution.
+ */
+MR_WEAK void mr_delay_ns(mr_uint32_t ns)
+{
+    if (ns == 0)
+    {
+        return;
+    }
+
+    mr_delay_us((ns + 999u) / 1000u);
+}
+
+/**
+ * @brief This function converts the ns to the ticks of mr_delay_tick.
+ *
+ * @param ns The ns to convert.
+ *
+ * @return The ticks.
+ *
+ * @note The default tick is 1ns, override it together with mr_delay_tick to delay on a hardware counter.
+ */
+MR_WEAK mr_uint32_t mr_delay_ns_to_tick(mr_uint32_t ns)
+{
+    return ns;
+}
+
+/**
+ * @brief This function delay the ticks.
+ *
+ * @param tick The ticks to delay, converted by mr_delay_ns_to_tick.
+ */
+MR_WEAK void mr_delay_tick(mr_uint32_t tick)
+{
+    mr_delay_ns(tick);
+}
+
 /**
  * @brief This function delay the us.
  *
@@ -593,6 +634,141 @@ mr_size_t mr_rb_write_force(mr_rb_t rb, const void *buffer, mr_size_t size)
     return size;
 }
 
+/**
+ * @brief This function update the write index of the ringbuffer.
+ *
+ * @param rb The ringbuffer to be updated.
+ * @param index The new write index, data before it has been filled externally (e.g. by DMA).
+ *
+ * @note If the new data exceeds the buffer space, the front data is discarded.
+ *
+ * @return The size of the new data.
+ */
+mr_size_t mr_rb_update_write_index(mr_rb_t rb, mr_size_t index)
+{
+    mr_size_t space_size = 0, size = 0;
+
+    MR_ASSERT(rb != MR_NULL);
+    MR_ASSERT(index <= rb->size);
+
+    if (rb->size == 0)
+    {
+        return 0;
+    }
+
+    /* The end of the buffer is the same as the start */
+    if (index == rb->size)
+    {
+        index = 0;
+    }
+
+    /* Get the size of the new data */
+    if (index >= rb->write_index)
+    {
+        size = index - rb->write_index;
+    } else
+    {
+        size = rb->size - rb->write_index + index;
+    }
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    /* Get the space size */
+    space_size = mr_rb_get_space_size(rb);
+
+    if (index <= rb->write_index)
+    {
+        rb->write_mirror = ~rb->write_mirror;
+    }
+    rb->write_index = index;
+
+    /* If the data exceeds the buffer space_size, the front data is discarded */
+    if (size > space_size)
+    {
+        rb->read_mirror = ~rb->write_mirror;
+        rb->read_index = rb->write_index;
+    }
+
+    return size;
+}
+
+/**
+ * @brief This function get the linear data of the ringbuffer.
+ *
+ * @param rb The ringbuffer to get the data from.
+ * @param data The pointer to store the start of the data.
+ *
+ * @note The data stays in the ringbuffer until it is discarded (e.g. when DMA has sent it).
+ *
+ * @return The size of the data that can be read without wrapping.
+ */
+mr_size_t mr_rb_get_linear_data(mr_rb_t rb, mr_uint8_t **data)
+{
+    mr_size_t data_size = 0;
+
+    MR_ASSERT(rb != MR_NULL);
+    MR_ASSERT(data != MR_NULL);
+
+    /* Get the data size */
+    data_size = mr_rb_get_data_size(rb);
+    if (data_size == 0)
+    {
+        return 0;
+    }
+
+    *data = &rb->buffer[rb->read_index];
+
+    /* The data ends at the end of the buffer */
+    if (data_size > (rb->size - rb->read_index))
+    {
+        return rb->size - rb->read_index;
+    }
+
+    return data_size;
+}
+
+/**
+ * @brief This function discard the data of the ringbuffer.
+ *
+ * @param rb The ringbuffer to be discarded.
+ * @param size The size of the data to discard.
+ *
+ * @return The size of the actual discarded data.
+ */
+mr_size_t mr_rb_discard(mr_rb_t rb, mr_size_t size)
+{
+    mr_size_t data_size = 0;
+
+    MR_ASSERT(rb != MR_NULL);
+
+    /* Get the data size */
+    data_size = mr_rb_get_data_size(rb);
+    if (data_size == 0)
+    {
+        return 0;
+    }
+
+    /* Adjust the number of bytes to discard if it exceeds the available data */
+    if (size > data_size)
+    {
+        size = data_size;
+    }
+
+    if ((rb->size - rb->read_index) > size)
+    {
+        rb->read_index += size;
+
+        return size;
+    }
+
+    rb->read_mirror = ~rb->read_mirror;
+    rb->read_index = size - (rb->size - rb->read_index);
+
+    return size;
+}
+
 static mr_int32_t mr_avl_get_height(mr_avl_t node)
 {
     if (node == MR_NULL)